@@ -0,0 +1,370 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/structs.h"
+#include "../include/ipc.h"
+#include "../include/timing.h"
+#include "../include/game_functions.h"
+#include "../include/greedy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLE_COUNTER "tsc"
+static inline uint64_t read_cycles(void) { return __rdtsc(); }
+#else
+#define BENCH_CYCLE_COUNTER "none" // Sin contador de ciclos portable: cycles_per_op queda en null
+static inline uint64_t read_cycles(void) { return 0; }
+#endif
+
+// Microbenchmarks de los nucleos de game_functions.c y del motor greedy del jugador sobre tableros
+// de 10x10 a 4000x4000. Cada caso se calienta, corre BENCH_DEFAULT_REPS repeticiones de al menos
+// BENCH_DEFAULT_MIN_MS y reporta ns y ciclos por operacion (min/mediana/max) en JSON.
+
+#define BENCH_DEFAULT_REPS 5
+#define BENCH_DEFAULT_MIN_MS 20
+#define BENCH_WARMUP_MS 10
+#define BENCH_MAX_REPS 64
+#define BENCH_MAX_SIZES 16
+#define BENCH_PLAYERS 9
+#define BENCH_SAMPLES 4096 // Posiciones/movimientos precalculados (potencia de dos)
+#define BENCH_BATCH 1024 // Operaciones por medicion de los nucleos baratos
+#define BENCH_OCCUPIED_PERCENT 30 // Celdas ocupadas del tablero de las consultas (mitad de partida)
+#define BENCH_SEED 42
+
+static const int DEFAULT_SIZES[][2] = { {10, 10}, {100, 100}, {1000, 1000}, {4000, 4000} };
+
+typedef struct {
+    uint64_t ns;
+    uint64_t cycles;
+} bench_time_t;
+
+typedef struct {
+    game_state_t* state;
+    board_t board;
+    int width;
+    int height;
+    unsigned char cell_bytes;
+    unsigned short xs[BENCH_SAMPLES]; // Celdas libres al azar del tablero de consultas
+    unsigned short ys[BENCH_SAMPLES];
+    unsigned char moves[BENCH_SAMPLES];
+    size_t walk; // apply_move: pasos dados sobre el recorrido en zigzag
+    uint64_t sink;
+} bench_context_t;
+
+typedef struct {
+    const char* name;
+    size_t batch; // Operaciones por llamada a run
+    bool query_board; // Necesita el tablero ocupado de las consultas
+    bench_time_t (*run)(bench_context_t* ctx, size_t ops);
+} bench_kernel_t;
+
+static uint64_t xorshift_state = 0x9E3779B97F4A7C15ull;
+
+static inline uint64_t next_random(void) {
+    xorshift_state ^= xorshift_state << 13;
+    xorshift_state ^= xorshift_state >> 7;
+    xorshift_state ^= xorshift_state << 17;
+    return xorshift_state;
+}
+
+static inline bench_time_t time_start(void) {
+    bench_time_t t = { monotonic_ns(), read_cycles() };
+    return t;
+}
+
+static inline bench_time_t time_since(bench_time_t start) {
+    bench_time_t t = { monotonic_ns() - start.ns, read_cycles() - start.cycles };
+    return t;
+}
+
+static void reset_state(bench_context_t* ctx) {
+    memset(ctx->state, 0, game_state_size(ctx->width, ctx->height, BENCH_PLAYERS, ctx->cell_bytes));
+    initialize_game_state(ctx->state, ctx->width, ctx->height, BENCH_PLAYERS, ctx->cell_bytes, BENCH_SEED);
+    ctx->board = game_board(ctx->state);
+    ctx->walk = 0;
+}
+
+// Tablero de mitad de partida: una fraccion de celdas tomadas por los jugadores y muestras al azar
+// de celdas libres y direcciones para las consultas
+static void prepare_query_board(bench_context_t* ctx) {
+    reset_state(ctx);
+    size_t cells = (size_t)ctx->width * ctx->height;
+    for (size_t i = 0; i < cells * BENCH_OCCUPIED_PERCENT / 100; i++) {
+        size_t cell = next_random() % cells;
+        set_cell_owner(&ctx->board, (int)(cell % ctx->width), (int)(cell / ctx->width), (int)(next_random() % BENCH_PLAYERS));
+    }
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        size_t cell;
+        do {
+            cell = next_random() % cells;
+        } while (!is_cell_free(&ctx->board, (int)(cell % ctx->width), (int)(cell / ctx->width)));
+        ctx->xs[i] = (unsigned short)(cell % ctx->width);
+        ctx->ys[i] = (unsigned short)(cell / ctx->width);
+        ctx->moves[i] = (unsigned char)(next_random() % NUM_DIRECTIONS);
+    }
+    for (unsigned int p = 0; p < ctx->state->player_count; p++) {
+        ctx->state->players[p].score = (unsigned int)(next_random() % 1000);
+        ctx->state->players[p].valid_moves = (unsigned int)(next_random() % 100);
+    }
+}
+
+static bench_time_t run_is_player_blocked(bench_context_t* ctx, size_t ops) {
+    uint64_t sink = 0;
+    bench_time_t start = time_start();
+    for (size_t i = 0; i < ops; i++) {
+        size_t k = i & (BENCH_SAMPLES - 1);
+        sink += is_player_blocked(&ctx->board, ctx->xs[k], ctx->ys[k]);
+    }
+    bench_time_t t = time_since(start);
+    ctx->sink += sink;
+    return t;
+}
+
+static bench_time_t run_is_valid_move(bench_context_t* ctx, size_t ops) {
+    uint64_t sink = 0;
+    bench_time_t start = time_start();
+    for (size_t i = 0; i < ops; i++) {
+        size_t k = i & (BENCH_SAMPLES - 1);
+        sink += (uint64_t)is_valid_move(&ctx->board, ctx->moves[k], ctx->xs[k], ctx->ys[k], false);
+    }
+    bench_time_t t = time_since(start);
+    ctx->sink += sink;
+    return t;
+}
+
+static bench_time_t run_determine_winner(bench_context_t* ctx, size_t ops) {
+    uint64_t sink = 0;
+    bench_time_t start = time_start();
+    for (size_t i = 0; i < ops; i++) {
+        ctx->state->players[i % BENCH_PLAYERS].score += (unsigned int)(i & 1); // Que el ganador no sea constante
+        sink += (uint64_t)determine_winner(ctx->state);
+    }
+    bench_time_t t = time_since(start);
+    ctx->sink += sink;
+    return t;
+}
+
+static bench_time_t run_evaluate_cell(bench_context_t* ctx, size_t ops) {
+    uint64_t sink = 0;
+    bench_time_t start = time_start();
+    for (size_t i = 0; i < ops; i++) {
+        size_t k = i & (BENCH_SAMPLES - 1);
+        sink += (uint64_t)evaluate_cell(&ctx->board, ctx->xs[k], ctx->ys[k], (int)(k & 7));
+    }
+    bench_time_t t = time_since(start);
+    ctx->sink += sink;
+    return t;
+}
+
+static bench_time_t run_calculate_move(bench_context_t* ctx, size_t ops) {
+    uint64_t sink = 0;
+    bench_time_t start = time_start();
+    for (size_t i = 0; i < ops; i++) {
+        size_t k = i & (BENCH_SAMPLES - 1);
+        sink += (uint64_t)calculate_move(&ctx->board, ctx->xs[k], ctx->ys[k], false, NULL);
+    }
+    bench_time_t t = time_since(start);
+    ctx->sink += sink;
+    return t;
+}
+
+// El jugador 0 recorre el tablero en zigzag desde (0, 0): todos los movimientos son validos y
+// cada uno captura una celda nueva. Al terminar el recorrido se reinicia el tablero (sin medir).
+static bench_time_t run_apply_move(bench_context_t* ctx, size_t ops) {
+    bench_time_t total = { 0, 0 };
+    size_t cells = (size_t)ctx->width * ctx->height;
+    while (ops > 0) {
+        if (ctx->walk == 0 || ctx->walk + 1 >= cells) {
+            reset_state(ctx);
+            ctx->state->players[0].x = 0;
+            ctx->state->players[0].y = 0;
+            set_cell_owner(&ctx->board, 0, 0, 0);
+            ctx->walk = 0;
+        }
+        size_t steps = cells - 1 - ctx->walk;
+        if (steps > ops) steps = ops;
+        bench_time_t start = time_start();
+        for (size_t i = 0; i < steps; i++) {
+            size_t next = ctx->walk + 1 + i; // Indice de la celda de destino en el recorrido
+            unsigned char move;
+            if (next % ctx->width == 0) {
+                move = MOVE_DOWN;
+            } else {
+                move = (next / ctx->width) % 2 == 0 ? MOVE_RIGHT : MOVE_LEFT;
+            }
+            apply_move(ctx->state, 0, move);
+        }
+        bench_time_t t = time_since(start);
+        total.ns += t.ns;
+        total.cycles += t.cycles;
+        ctx->walk += steps;
+        ops -= steps;
+    }
+    ctx->sink += ctx->state->players[0].score;
+    return total;
+}
+
+static bench_time_t run_initialize_board(bench_context_t* ctx, size_t ops) {
+    bench_time_t start = time_start();
+    for (size_t i = 0; i < ops; i++) {
+        initialize_board(ctx->state, BENCH_SEED + (unsigned int)i);
+    }
+    bench_time_t t = time_since(start);
+    ctx->sink += (uint64_t)board_cell(&ctx->board, 0, 0);
+    ctx->walk = 0; // El tablero cambio: apply_move reinicia su recorrido
+    return t;
+}
+
+static const bench_kernel_t KERNELS[] = {
+    { "is_player_blocked", BENCH_BATCH, true, run_is_player_blocked },
+    { "is_valid_move", BENCH_BATCH, true, run_is_valid_move },
+    { "determine_winner", BENCH_BATCH, true, run_determine_winner },
+    { "evaluate_cell", BENCH_BATCH, true, run_evaluate_cell },
+    { "calculate_move", BENCH_BATCH, true, run_calculate_move },
+    { "apply_move", BENCH_BATCH, false, run_apply_move },
+    { "initialize_board", 1, false, run_initialize_board },
+};
+#define KERNEL_COUNT (sizeof(KERNELS) / sizeof(KERNELS[0]))
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Corre el nucleo en tandas hasta juntar min_ns de medicion; devuelve las operaciones hechas
+static size_t measure(const bench_kernel_t* kernel, bench_context_t* ctx, uint64_t min_ns, bench_time_t* total) {
+    size_t ops = 0;
+    total->ns = 0;
+    total->cycles = 0;
+    while (total->ns < min_ns) {
+        bench_time_t t = kernel->run(ctx, kernel->batch);
+        total->ns += t.ns;
+        total->cycles += t.cycles;
+        ops += kernel->batch;
+    }
+    return ops;
+}
+
+static void print_stat(FILE* out, const char* key, double* values, int count, bool null_value) {
+    if (null_value) {
+        fprintf(out, "\"%s\": null", key);
+        return;
+    }
+    qsort(values, (size_t)count, sizeof(double), compare_double);
+    fprintf(out, "\"%s\": {\"min\": %.3f, \"median\": %.3f, \"max\": %.3f}", key, values[0], values[count / 2], values[count - 1]);
+}
+
+static void run_size(FILE* out, bool* first, int width, int height, unsigned char cell_bytes, int reps, uint64_t min_ns, const char* filter) {
+    bench_context_t* ctx = calloc(1, sizeof(bench_context_t));
+    size_t size = game_state_size(width, height, BENCH_PLAYERS, cell_bytes);
+    void* memory = NULL;
+    if (!ctx || posix_memalign(&memory, SHM_ALIGNMENT, size) != 0) {
+        fprintf(stderr, "Sin memoria para el tablero de %dx%d\n", width, height);
+        free(ctx);
+        return;
+    }
+    ctx->state = memory;
+    ctx->width = width;
+    ctx->height = height;
+    ctx->cell_bytes = cell_bytes;
+    prepare_query_board(ctx);
+    bool query_board = true;
+
+    for (size_t k = 0; k < KERNEL_COUNT; k++) {
+        const bench_kernel_t* kernel = &KERNELS[k];
+        if (filter && !strstr(kernel->name, filter)) continue;
+        if (kernel->query_board && !query_board) {
+            prepare_query_board(ctx);
+        }
+        query_board = kernel->query_board;
+
+        bench_time_t total;
+        measure(kernel, ctx, (uint64_t)BENCH_WARMUP_MS * MS_TO_NS, &total);
+        double ns_per_op[BENCH_MAX_REPS], cycles_per_op[BENCH_MAX_REPS];
+        size_t ops = 0;
+        for (int r = 0; r < reps; r++) {
+            ops = measure(kernel, ctx, min_ns, &total);
+            ns_per_op[r] = (double)total.ns / (double)ops;
+            cycles_per_op[r] = (double)total.cycles / (double)ops;
+        }
+        bool no_cycles = strcmp(BENCH_CYCLE_COUNTER, "none") == 0;
+        fprintf(out, "%s    {\"kernel\": \"%s\", \"width\": %d, \"height\": %d, \"cell_bytes\": %u, \"reps\": %d, \"ops_per_rep\": %zu, ",
+                *first ? "" : ",\n", kernel->name, width, height, cell_bytes, reps, ops);
+        print_stat(out, "ns_per_op", ns_per_op, reps, false);
+        fprintf(out, ", ");
+        print_stat(out, "cycles_per_op", cycles_per_op, reps, no_cycles);
+        fprintf(out, "}");
+        *first = false;
+        fprintf(stderr, "%-18s %5dx%-5d %12.2f ns/op %12.1f ciclos/op\n", kernel->name, width, height,
+                ns_per_op[reps / 2], no_cycles ? 0.0 : cycles_per_op[reps / 2]);
+    }
+    fflush(out);
+    if (ctx->sink == 42) fprintf(stderr, " "); // Que el compilador no descarte los resultados
+    free(ctx->state);
+    free(ctx);
+}
+
+int main(int argc, char* argv[]) {
+    int sizes[BENCH_MAX_SIZES][2];
+    int size_count = 0;
+    int reps = BENCH_DEFAULT_REPS;
+    long min_ms = BENCH_DEFAULT_MIN_MS;
+    unsigned char cell_bytes = sizeof(int);
+    const char* output_path = NULL;
+    const char* filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            int w, h;
+            if (size_count == BENCH_MAX_SIZES || sscanf(argv[++i], "%dx%d", &w, &h) != 2 || w < MIN_BOARD_SIZE || h < MIN_BOARD_SIZE) {
+                fprintf(stderr, "Tamaño invalido: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            sizes[size_count][0] = w;
+            sizes[size_count][1] = h;
+            size_count++;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            min_ms = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            cell_bytes = COMPACT_CELL_BYTES;
+        } else {
+            fprintf(stderr, "Uso: %s [-s WxH]... [-r repeticiones] [-t ms_por_repeticion] [-k nucleo] [-o salida.json] [--compact]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (reps < 1 || reps > BENCH_MAX_REPS || min_ms < 1) {
+        fprintf(stderr, "Parametros invalidos\n");
+        return EXIT_FAILURE;
+    }
+    if (size_count == 0) {
+        size_count = (int)(sizeof(DEFAULT_SIZES) / sizeof(DEFAULT_SIZES[0]));
+        memcpy(sizes, DEFAULT_SIZES, sizeof(DEFAULT_SIZES));
+    }
+
+    FILE* out = stdout;
+    if (output_path && !(out = fopen(output_path, "w"))) {
+        perror(output_path);
+        return EXIT_FAILURE;
+    }
+    fprintf(out, "{\n  \"suite\": \"game_functions\",\n  \"cycle_counter\": \"%s\",\n  \"warmup_ms\": %d,\n  \"min_ms_per_rep\": %ld,\n  \"results\": [\n",
+            BENCH_CYCLE_COUNTER, BENCH_WARMUP_MS, min_ms);
+    bool first = true;
+    for (int s = 0; s < size_count; s++) {
+        run_size(out, &first, sizes[s][0], sizes[s][1], cell_bytes, reps, (uint64_t)min_ms * MS_TO_NS, filter);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+        fprintf(stderr, "Resultados en %s\n", output_path);
+    }
+    return EXIT_SUCCESS;
+}
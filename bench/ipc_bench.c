@@ -0,0 +1,219 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/structs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// Rendimiento de punta a punta del protocolo máster/jugador: corre bin/master --turbo con N
+// jugadores sinteticos (bench/synthetic_player.c, contestan al instante) y una cantidad fija de
+// movimientos (--max-moves), para cada transporte, cantidad de jugadores y tamaño de tablero.
+// Lee del máster los movimientos/s y la latencia de ida y vuelta (sem_post del turno hasta leer
+// el movimiento) y escribe una fila CSV por corrida.
+
+#define DEFAULT_MASTER_PATH "./bin/master"
+#define DEFAULT_PLAYER_PATH "./bin/synthetic_player"
+#define DEFAULT_MOVES 20000
+#define DEFAULT_REPS 3
+#define DEFAULT_TIMEOUT_SEC 10
+#define MAX_SWEEP 16
+#define MASTER_OUTPUT_SIZE 4096
+#define MAX_MASTER_ARGS (32 + MAX_PLAYERS)
+
+// Cada transporte es el nombre de la columna CSV y las opciones extra del máster que lo activan
+typedef struct {
+    const char* name;
+    const char* master_args[2];
+} transport_t;
+
+static const transport_t TRANSPORTS[] = {
+    { "pipe", { NULL, NULL } }, // pipe anonimo por jugador + semaforo player_turn
+    { "shm", { "--transport", "shm" } }, // anillo SPSC por jugador en /game_moves + futex
+};
+#define TRANSPORT_COUNT (sizeof(TRANSPORTS) / sizeof(TRANSPORTS[0]))
+
+static const int DEFAULT_PLAYER_COUNTS[] = { 1, 2, 4, 8 };
+static const int DEFAULT_SIZES[][2] = { {100, 100}, {1000, 1000} };
+
+typedef struct {
+    unsigned long moves;
+    double seconds;
+    double moves_per_s;
+    double p50_us;
+    double p99_us;
+} run_result_t;
+
+// Corre una partida y parsea la linea "Turbo:" de su salida. Devuelve 0 si la encontro.
+static int run_master(const char* master_path, const char* player_path, const transport_t* transport,
+                      int players, int width, int height, unsigned long moves, run_result_t* result) {
+    char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE], moves_str[2 * ARG_BUFFER_SIZE];
+    char timeout_str[ARG_BUFFER_SIZE], game_id[GAME_ID_MAX_LENGTH + 1];
+    snprintf(width_str, sizeof(width_str), "%d", width);
+    snprintf(height_str, sizeof(height_str), "%d", height);
+    snprintf(moves_str, sizeof(moves_str), "%lu", moves);
+    snprintf(timeout_str, sizeof(timeout_str), "%d", DEFAULT_TIMEOUT_SEC);
+    snprintf(game_id, sizeof(game_id), "ipcbench%ld", (long)getpid()); // No pisa partidas en curso
+
+    const char* args[MAX_MASTER_ARGS];
+    int n = 0;
+    args[n++] = master_path;
+    args[n++] = "--turbo";
+    args[n++] = "-w"; args[n++] = width_str;
+    args[n++] = "-h"; args[n++] = height_str;
+    args[n++] = "-s"; args[n++] = "1";
+    args[n++] = "-t"; args[n++] = timeout_str;
+    args[n++] = "-g"; args[n++] = game_id;
+    args[n++] = "--max-moves"; args[n++] = moves_str;
+    for (int a = 0; a < 2 && transport->master_args[a]; a++) {
+        args[n++] = transport->master_args[a];
+    }
+    args[n++] = "-p";
+    for (int p = 0; p < players; p++) {
+        args[n++] = player_path;
+    }
+    args[n] = NULL;
+
+    int pipefd[2];
+    if (pipe(pipefd) == -1) {
+        perror("pipe");
+        return ERR_GENERIC;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return ERR_FORK;
+    }
+    if (pid == 0) {
+        dup2(pipefd[1], STDOUT_FILENO);
+        close(pipefd[0]);
+        close(pipefd[1]);
+        execv(master_path, (char* const*)args);
+        perror("Error haciendo el execv");
+        _exit(EXIT_FAILURE);
+    }
+    close(pipefd[1]);
+    FILE* out = fdopen(pipefd[0], "r");
+    char line[MASTER_OUTPUT_SIZE];
+    bool found = false;
+    while (out && fgets(line, sizeof(line), out)) {
+        if (!found && sscanf(line, "Turbo: movimientos=%lu tiempo_s=%lf mov_por_s=%lf p50_us=%lf p99_us=%lf",
+                             &result->moves, &result->seconds, &result->moves_per_s, &result->p50_us, &result->p99_us) == 5) {
+            found = true;
+        }
+    }
+    if (out) {
+        fclose(out);
+    } else {
+        close(pipefd[0]);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return found ? 0 : ERR_GENERIC;
+}
+
+static int parse_list(const char* text, int* values) {
+    int count = 0;
+    char* copy = strdup(text);
+    for (char* token = strtok(copy, ","); token && count < MAX_SWEEP; token = strtok(NULL, ",")) {
+        values[count++] = atoi(token);
+    }
+    free(copy);
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    const char* master_path = DEFAULT_MASTER_PATH;
+    const char* player_path = DEFAULT_PLAYER_PATH;
+    int player_counts[MAX_SWEEP], sizes[MAX_SWEEP][2];
+    const transport_t* transports[MAX_SWEEP];
+    int player_sweep = 0, size_sweep = 0, transport_sweep = 0;
+    unsigned long moves = DEFAULT_MOVES;
+    int reps = DEFAULT_REPS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            master_path = argv[++i];
+        } else if (strcmp(argv[i], "-y") == 0 && i + 1 < argc) {
+            player_path = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            player_sweep = parse_list(argv[++i], player_counts);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            int w, h;
+            if (size_sweep == MAX_SWEEP || sscanf(argv[++i], "%dx%d", &w, &h) != 2) {
+                fprintf(stderr, "Tamaño invalido: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            sizes[size_sweep][0] = w;
+            sizes[size_sweep][1] = h;
+            size_sweep++;
+        } else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            const transport_t* found = NULL;
+            for (size_t t = 0; t < TRANSPORT_COUNT; t++) {
+                if (strcmp(TRANSPORTS[t].name, name) == 0) found = &TRANSPORTS[t];
+            }
+            if (!found || transport_sweep == MAX_SWEEP) {
+                fprintf(stderr, "Transporte desconocido: %s\n", name);
+                return EXIT_FAILURE;
+            }
+            transports[transport_sweep++] = found;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            moves = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Uso: %s [-m master] [-y jugador] [-x transporte]... [-p 1,2,4,8] [-b WxH]... [-n movimientos] [-r repeticiones]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (player_sweep == 0) {
+        player_sweep = (int)(sizeof(DEFAULT_PLAYER_COUNTS) / sizeof(DEFAULT_PLAYER_COUNTS[0]));
+        memcpy(player_counts, DEFAULT_PLAYER_COUNTS, sizeof(DEFAULT_PLAYER_COUNTS));
+    }
+    if (size_sweep == 0) {
+        size_sweep = (int)(sizeof(DEFAULT_SIZES) / sizeof(DEFAULT_SIZES[0]));
+        memcpy(sizes, DEFAULT_SIZES, sizeof(DEFAULT_SIZES));
+    }
+    if (transport_sweep == 0) {
+        for (size_t t = 0; t < TRANSPORT_COUNT; t++) transports[transport_sweep++] = &TRANSPORTS[t];
+    }
+    for (int p = 0; p < player_sweep; p++) {
+        if (player_counts[p] < 1 || player_counts[p] > MAX_PLAYERS) {
+            fprintf(stderr, "Cantidad de jugadores invalida: %d\n", player_counts[p]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (reps < 1 || moves == 0) {
+        fprintf(stderr, "Parametros invalidos\n");
+        return EXIT_FAILURE;
+    }
+    if (access(master_path, X_OK) != 0 || access(player_path, X_OK) != 0) {
+        fprintf(stderr, "No se encuentra %s o %s (¿make all bench?)\n", master_path, player_path);
+        return EXIT_FAILURE;
+    }
+
+    printf("transport,players,width,height,rep,moves,seconds,moves_per_s,p50_us,p99_us\n");
+    int failures = 0;
+    for (int t = 0; t < transport_sweep; t++) {
+        for (int s = 0; s < size_sweep; s++) {
+            for (int p = 0; p < player_sweep; p++) {
+                for (int r = 0; r < reps; r++) {
+                    run_result_t result = {0};
+                    if (run_master(master_path, player_path, transports[t], player_counts[p], sizes[s][0], sizes[s][1], moves, &result) != 0) {
+                        fprintf(stderr, "Fallo la corrida %s/%d jugadores/%dx%d\n", transports[t]->name, player_counts[p], sizes[s][0], sizes[s][1]);
+                        failures++;
+                        continue;
+                    }
+                    printf("%s,%d,%d,%d,%d,%lu,%.6f,%.1f,%.2f,%.2f\n", transports[t]->name, player_counts[p], sizes[s][0], sizes[s][1],
+                           r, result.moves, result.seconds, result.moves_per_s, result.p50_us, result.p99_us);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,201 @@
+#define _DEFAULT_SOURCE
+#include "../include/structs.h"
+#include "../include/ipc.h"
+#include "../include/timing.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Contencion del máster frente a N lectores: protocolo de semaforos original vs seqlock.
+// El escritor imita al máster (apply_move: tablero, plano de libres, jugador y delta); los
+// lectores imitan al jugador (copian el tablero completo y su posicion) en un bucle cerrado.
+
+#define DEFAULT_BENCH_WIDTH 100
+#define DEFAULT_BENCH_HEIGHT 100
+#define DEFAULT_DURATION_MS 300
+#define DEFAULT_WRITE_INTERVAL_NS 2000
+#define DEFAULT_MAX_READERS 9
+#define BENCH_PLAYERS 9
+#define BENCH_SEED 42
+#define MAX_LATENCY_SAMPLES (1 << 21)
+
+typedef enum {
+    SCHEME_RWSEM,
+    SCHEME_SEQLOCK
+} sync_scheme_t;
+
+typedef struct {
+    volatile int stop;
+    uint64_t reads[MAX_PLAYERS];
+    uint64_t retries[MAX_PLAYERS];
+} bench_control_t;
+
+static void reader_loop(sync_scheme_t scheme, game_state_t* state, game_sync_t* sync, bench_control_t* control, int id) {
+    board_t board = game_board(state);
+    size_t bytes = board_bytes(state->height, (int)state->board_stride, state->cell_bytes);
+    void* copy = malloc(bytes);
+    uint64_t reads = 0, retries = 0;
+    volatile unsigned short sink = 0;
+
+    while (!control->stop) {
+        if (scheme == SCHEME_RWSEM) {
+            reader_enter(sync);
+            memcpy(copy, board.cells, bytes);
+            sink = state->players[id % BENCH_PLAYERS].x;
+            reader_exit(sync);
+        } else {
+            unsigned int seq;
+            bool first = true;
+            do {
+                if (!first) retries++;
+                first = false;
+                seq = state_read_begin(state);
+                memcpy(copy, board.cells, bytes);
+                sink = state->players[id % BENCH_PLAYERS].x;
+            } while (state_read_retry(state, seq));
+        }
+        reads++;
+    }
+    (void)sink;
+    control->reads[id] = reads;
+    control->retries[id] = retries;
+    free(copy);
+}
+
+static void spin_ns(uint64_t ns) {
+    uint64_t until = monotonic_ns() + ns;
+    while (monotonic_ns() < until) {
+    }
+}
+
+static void run_case(sync_scheme_t scheme, int readers, int width, int height, int duration_ms, uint64_t interval_ns, uint64_t* samples) {
+    size_t state_size = game_state_size(width, height, BENCH_PLAYERS, sizeof(int));
+    size_t sync_size = game_sync_size(BENCH_PLAYERS);
+    size_t total = state_size + sync_size + sizeof(bench_control_t);
+    char* region = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    memset(region, 0, total);
+    game_state_t* state = (game_state_t*)region;
+    game_sync_t* sync = (game_sync_t*)(region + state_size);
+    bench_control_t* control = (bench_control_t*)(region + state_size + sync_size);
+
+    initialize_game_state(state, width, height, BENCH_PLAYERS, sizeof(int), BENCH_SEED);
+    initialize_semaphores(sync, BENCH_PLAYERS);
+
+    pid_t pids[MAX_PLAYERS];
+    for (int r = 0; r < readers; r++) {
+        pids[r] = fork();
+        if (pids[r] == 0) {
+            reader_loop(scheme, state, sync, control, r);
+            _exit(EXIT_SUCCESS);
+        }
+    }
+
+    board_t board = game_board(state);
+    size_t writes = 0;
+    unsigned int resets = 0;
+    uint64_t start_ns = monotonic_ns();
+    uint64_t end_ns = start_ns + (uint64_t)duration_ms * MS_TO_NS;
+    while (monotonic_ns() < end_ns) {
+        int id = (int)(writes % BENCH_PLAYERS);
+        unsigned char mask = legal_move_mask(&board, state->players[id].x, state->players[id].y);
+        uint64_t t0 = monotonic_ns();
+        if (scheme == SCHEME_RWSEM) {
+            writer_enter(sync);
+        }
+        state_write_begin(state);
+        if (mask) {
+            apply_move(state, id, (unsigned char)__builtin_ctz(mask));
+        } else {
+            // Jugador encerrado: se vuelve a sembrar el tablero para seguir escribiendo (no se mide)
+            initialize_board(state, BENCH_SEED + ++resets);
+            place_players_on_board(state);
+        }
+        state_write_end(state);
+        if (scheme == SCHEME_RWSEM) {
+            writer_exit(sync);
+        }
+        if (!mask) {
+            continue;
+        }
+        if (writes < MAX_LATENCY_SAMPLES) {
+            samples[writes] = monotonic_ns() - t0;
+        }
+        writes++;
+        spin_ns(interval_ns);
+    }
+    uint64_t elapsed_ns = monotonic_ns() - start_ns;
+
+    control->stop = 1;
+    for (int r = 0; r < readers; r++) {
+        waitpid(pids[r], NULL, 0);
+    }
+
+    uint64_t reads = 0, retries = 0;
+    for (int r = 0; r < readers; r++) {
+        reads += control->reads[r];
+        retries += control->retries[r];
+    }
+    size_t recorded = writes < MAX_LATENCY_SAMPLES ? writes : MAX_LATENCY_SAMPLES;
+    uint64_t p50 = percentile_ns(samples, recorded, 50);
+    uint64_t p99 = percentile_ns(samples, recorded, 99);
+    double seconds = (double)elapsed_ns / NS_PER_SEC;
+    printf("%s,%d,%.0f,%llu,%llu,%.0f,%llu\n", scheme == SCHEME_RWSEM ? "rwsem" : "seqlock", readers,
+           writes / seconds, (unsigned long long)p50, (unsigned long long)p99, reads / seconds, (unsigned long long)retries);
+    fflush(stdout);
+
+    cleanup_semaphores(sync, BENCH_PLAYERS);
+    munmap(region, total);
+}
+
+int main(int argc, char* argv[]) {
+    int width = DEFAULT_BENCH_WIDTH, height = DEFAULT_BENCH_HEIGHT;
+    int duration_ms = DEFAULT_DURATION_MS, max_readers = DEFAULT_MAX_READERS;
+    uint64_t interval_ns = DEFAULT_WRITE_INTERVAL_NS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            duration_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            interval_ns = (uint64_t)atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            max_readers = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Uso: %s [-w ancho] [-h alto] [-d duracion_ms] [-i intervalo_escritura_ns] [-r max_lectores]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (width < 1 || height < 1 || duration_ms < 1 || max_readers < 1 || max_readers > MAX_PLAYERS) {
+        fprintf(stderr, "Parametros invalidos\n");
+        return EXIT_FAILURE;
+    }
+
+    uint64_t* samples = malloc(MAX_LATENCY_SAMPLES * sizeof(uint64_t));
+    if (!samples) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    printf("scheme,readers,writes_per_s,write_p50_ns,write_p99_ns,reads_per_s,reader_retries\n");
+    for (int readers = 1; readers <= max_readers; readers++) {
+        run_case(SCHEME_RWSEM, readers, width, height, duration_ms, interval_ns, samples);
+        run_case(SCHEME_SEQLOCK, readers, width, height, duration_ms, interval_ns, samples);
+    }
+    free(samples);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/structs.h"
+#include "../include/ipc.h"
+#include "../include/bitboard.h"
+#include "../include/move_channel.h"
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// Jugador sintetico para ipc_bench: contesta apenas recibe el turno, sin copiar el estado. La
+// jugada sale de una tabla precalculada por (direccion anterior, movimientos legales): sigue derecho
+// mientras puede y si no dobla a la derecha, asi que recorre el tablero en espiral hacia adentro y
+// casi todo movimiento es valido.
+
+static const int TURN_PREFERENCE[NUM_DIRECTIONS] = { 0, 2, -2, 1, -1, 3, -3, 4 }; // En pasos de 45°, + es horario
+static unsigned char next_move[NUM_DIRECTIONS][1 << NUM_DIRECTIONS];
+
+static void precompute_moves(void) {
+    for (int previous = 0; previous < NUM_DIRECTIONS; previous++) {
+        for (int legal = 1; legal < (1 << NUM_DIRECTIONS); legal++) {
+            for (int turn = 0; turn < NUM_DIRECTIONS; turn++) {
+                int d = (previous + TURN_PREFERENCE[turn] + NUM_DIRECTIONS) % NUM_DIRECTIONS;
+                if (legal & (1 << d)) {
+                    next_move[previous][legal] = (unsigned char)d;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Primero hacia el borde mas cercano: la espiral arranca por el perimetro. En un empate entre dos
+// bordes se elige el que al doblar a la derecha lleva al otro (desde una esquina se sigue por ella).
+static unsigned char first_direction(int x, int y, int width, int height) {
+    int distance[NUM_DIRECTIONS] = {0};
+    distance[MOVE_LEFT] = x;
+    distance[MOVE_UP] = y;
+    distance[MOVE_RIGHT] = width - 1 - x;
+    distance[MOVE_DOWN] = height - 1 - y;
+    static const unsigned char order[] = { MOVE_LEFT, MOVE_UP, MOVE_RIGHT, MOVE_DOWN };
+    unsigned char best = MOVE_LEFT;
+    for (int k = 1; k < 4; k++) {
+        if (distance[order[k]] < distance[best]) best = order[k];
+    }
+    if (best == MOVE_LEFT && distance[MOVE_DOWN] == distance[MOVE_LEFT] && distance[MOVE_UP] > distance[MOVE_LEFT]) {
+        best = MOVE_DOWN;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <width> <height>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    game_state_t* game_state = setup_game_state(atoi(argv[1]), atoi(argv[2]));
+    game_sync_t* game_sync = setup_game_sync();
+    if (!game_state || !game_sync) {
+        fprintf(stderr, "Error al inicializar el estado del juego o la sincronización\n");
+        return EXIT_FAILURE;
+    }
+    int id = -1;
+    pid_t my_pid = getpid();
+    for (unsigned int i = 0; i < game_state->player_count; i++) {
+        if (game_state->players[i].pid == my_pid) {
+            id = (int)i;
+        }
+    }
+    if (id == -1) {
+        return EXIT_FAILURE;
+    }
+    move_channels_t* channels = move_channels_connect(); // NULL con el transporte por pipes
+    if (transport_is_shm() && !channels) {
+        return EXIT_FAILURE;
+    }
+    uint32_t turns = 0;
+    precompute_moves();
+
+    // La posicion propia solo cambia antes de que el máster nos de el turno. Los vecinos se leen sin
+    // seqlock: si un rival los toma justo entonces el movimiento sale invalido y el máster igual lo procesa
+    board_t board = game_board(game_state);
+    const player_t* me = &game_state->players[id];
+    unsigned char previous = first_direction(me->x, me->y, game_state->width, game_state->height);
+    for (;;) {
+        if (channels) {
+            move_channel_wait_turn(channels, id, &turns);
+        } else {
+            sem_wait(&game_sync->player_turn[id]);
+        }
+        if (__atomic_load_n(&game_state->is_game_over, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        unsigned char legal = legal_move_mask(&board, me->x, me->y);
+        if (!legal) {
+            break;
+        }
+        previous = next_move[previous][legal];
+        if (channels) {
+            move_channel_push(channels, id, previous);
+        } else if (write(STDOUT_FILENO, &previous, MOVE_DATA_SIZE) != MOVE_DATA_SIZE) {
+            break;
+        }
+    }
+    if (channels) move_channel_close(channels, id);
+    return EXIT_SUCCESS;
+}
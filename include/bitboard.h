@@ -0,0 +1,21 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+#include "structs.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Plano de celdas libres: un bit por celda, (height + 2) filas de free_stride palabras con
+// un borde en cero, asi que las consultas de vecinos no necesitan chequear limites.
+// Se mantiene al dia desde board_set_cell (set_cell_owner, apply_move y los deltas del jugador).
+
+size_t free_plane_words(int width, int height); // incluye las palabras de resguardo
+size_t free_plane_bytes(int width, int height);
+uint64_t* free_plane_alloc(int width, int height); // plano privado en cero (libre con free_plane_release)
+void free_plane_release(uint64_t* bits);
+void free_plane_build(board_t* board); // recalcula el plano a partir de las celdas
+void free_plane_update(board_t* board, int x, int y, int value);
+
+// Bit d encendido si la celda vecina en la direccion d (MOVE_DELTAS) esta libre
+unsigned char legal_move_mask(const board_t* board, int x, int y);
+
+#endif
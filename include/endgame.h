@@ -0,0 +1,42 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+#include "structs.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ENDGAME_EXACT_MAX_CELLS 64 // Regiones de hasta este tamaño se resuelven exacto (una mascara de 64 bits)
+#define ENDGAME_CLOCK_CHECK_NODES 1024 // Nodos del branch-and-bound entre consultas al reloj
+#define ENDGAME_DEGREE_WEIGHT 16 // Peso de cada salida libre en el recorrido heuristico (Warnsdorff)
+#define ENDGAME_CUT_PROBE_CELLS 64 // Celdas que se rellenan como maximo al medir lo que aisla un paso del recorrido
+#define ENDGAME_WALK_CHECK_STEPS 64 // Pasos del recorrido heuristico entre consultas al reloj
+#define ENDGAME_HEURISTIC_VARIANTS 4 // Pesos de recompensa que se prueban en el recorrido heuristico
+#define ENDGAME_SEAL_MAX_CELLS 4096 // Tope del relleno que busca rivales: una region mayor todavia no cuenta como aislada
+#define ENDGAME_SEAL_CELLS_PER_TURN 256 // Celdas por turno, en promedio, que se gastan en buscar el aislamiento
+
+// Final en solitario: cuando la region libre del jugador ya no toca a ningun rival, el resto de
+// su partida es un camino de peso maximo dentro de esa region. Se calcula un plan una vez y
+// se juega movimiento a movimiento; mientras el plan no sea optimo probado (region chica cuyo
+// branch-and-bound no termino a tiempo, o region grande que se achica) se reintenta mejorarlo.
+typedef struct {
+    int width;
+    int height;
+    unsigned int generation;
+    unsigned int* stamp; // Marcas de los rellenos y recorridos
+    int* queue; // Celdas de la region, en orden BFS
+    unsigned char* plan; // Direcciones (MOVE_DELTAS) a jugar
+    unsigned char* candidate; // Recorrido heuristico en curso (se intercambia con plan si es mejor)
+    int plan_length;
+    int plan_next;
+    int plan_x, plan_y; // Donde tiene que estar el jugador para jugar plan[plan_next]
+    bool sealed; // La region ya no toca rivales (no cambia mas: las celdas solo se ocupan)
+    int seal_wait; // Turnos que faltan para volver a buscar el aislamiento
+    bool exact; // El plan restante es optimo
+} endgame_t;
+
+int endgame_init(endgame_t* endgame, int width, int height);
+void endgame_free(endgame_t* endgame);
+// Si el jugador me quedo aislado escribe su movimiento en *move (-1 si no le quedan) y
+// devuelve true; si no, devuelve false y el turno lo decide el motor elegido
+bool endgame_move(endgame_t* endgame, const board_t* board, const player_t* players, unsigned int player_count, int me, uint64_t deadline_ns, signed char* move);
+
+#endif
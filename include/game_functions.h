@@ -7,15 +7,21 @@
 #include <stdbool.h>
 
 
+// acceso a celdas: valen para tableros int y compactos (int8_t) y aceptan el borde (-1 y width/height)
+size_t board_bytes(int height, int stride, unsigned char cell_bytes); // tablero completo con borde
+int board_cell(const board_t* board, int x, int y);
+void board_set_cell(board_t* board, int x, int y, int value);
+
 // tablero y movimientos
 void initialize_board(game_state_t* state, unsigned int seed);
 bool is_valid_position(int x, int y, int width, int height);
-bool is_cell_free(int* board, int x, int y, int width, int height);
-int get_cell_value(int* board, int x, int y, int width, int height);
-void set_cell_owner(game_state_t* state, int x, int y, int player_id);
+bool is_cell_free(const board_t* board, int x, int y); // sin chequeo de limites: el borde cuenta como ocupado
+int get_cell_value(const board_t* board, int x, int y);
+void set_cell_owner(board_t* board, int x, int y, int player_id);
 void place_players_on_board(game_state_t* state);
 void apply_move(game_state_t* game_state,int  player_id, unsigned char move);
-int is_valid_move(int* board, unsigned char move, int x, int y, bool blocked, int width, int height);
+void record_delta(game_state_t* state, int player_id, int x, int y); // publica la celda capturada en el anillo de deltas
+int is_valid_move(const board_t* board, unsigned char move, int x, int y, bool blocked);
 int determine_winner(game_state_t* state);
-bool is_player_blocked(int* board, int x, int y, int width, int height);
+bool is_player_blocked(const board_t* board, int x, int y);
 #endif
@@ -0,0 +1,68 @@
+#ifndef GAME_STATS_H
+#define GAME_STATS_H
+#include "structs.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define GAME_STATS_SHM "/game_stats"
+#define GAME_STATS_MAGIC 0x43435354u // "CCST"
+#define GAME_STATS_VERSION 1
+// Histograma log-lineal (estilo HDR): los valores menores a STATS_SUB_BUCKETS van uno por balde y
+// cada potencia de dos siguiente se parte en STATS_SUB_BUCKETS baldes (error relativo <= 1/8)
+#define STATS_SUB_BUCKET_BITS 3
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BUCKET_BITS)
+#define STATS_MAX_EXPONENT 36 // 2^37 ns (~137 s): lo que pasa de ahi cae en el ultimo balde
+#define STATS_BUCKETS (STATS_SUB_BUCKETS * (STATS_MAX_EXPONENT - STATS_SUB_BUCKET_BITS + 2))
+
+// Etapas medidas por el máster en cada movimiento, todas con CLOCK_MONOTONIC
+enum StatsStage {
+    STATS_THINK, // sem_post(player_turn) hasta leer el movimiento del pipe (piensa el jugador)
+    STATS_LOCK_WAIT, // Espera para entrar a escribir el estado (writer_mutex/state_mutex con --sync rwsem)
+    STATS_CRITICAL, // Validar y aplicar el movimiento con el estado tomado
+    STATS_VIEW, // view_notify hasta view_done (solo con vista sincronizada)
+    STATS_STAGE_COUNT
+};
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t buckets[STATS_BUCKETS];
+} stats_histogram_t;
+
+typedef struct {
+    pid_t pid;
+    uint32_t reserved;
+    stats_histogram_t stages[STATS_STAGE_COUNT];
+} stats_player_t;
+
+// Segmento /game_stats: lo escribe solo el máster, sin locks (un unico escritor, cada contador se
+// publica con un store atomico). Un lector puede ver un histograma a mitad de un registro: count,
+// la suma y los baldes pueden diferir en una muestra, nunca mas.
+typedef struct {
+    uint32_t magic; // GAME_STATS_MAGIC, se escribe al final de la inicializacion
+    uint32_t version;
+    uint32_t player_count;
+    uint32_t stage_count;
+    uint32_t bucket_count;
+    pid_t master_pid;
+    uint64_t started_ns; // Reloj monotonico al crear el segmento
+    uint64_t updated_ns; // Ultimo movimiento registrado
+    bool finished; // La partida termino
+    stats_player_t players[];
+} game_stats_t;
+
+size_t game_stats_size(int player_count);
+void game_stats_init(game_stats_t* stats, int player_count);
+// Un registro por etapa y movimiento; solo lo llama el máster
+void game_stats_record(game_stats_t* stats, int player, int stage, uint64_t value_ns);
+const char* game_stats_stage_name(int stage);
+
+int stats_bucket_index(uint64_t value_ns);
+uint64_t stats_bucket_upper_ns(int index); // Mayor valor que cae en el balde
+// Percentil (0-100) de un histograma, como cota superior de su balde; 0 si esta vacio
+uint64_t stats_percentile_ns(const stats_histogram_t* histogram, unsigned int percentile);
+
+#endif
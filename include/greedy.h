@@ -0,0 +1,14 @@
+#ifndef GREEDY_H
+#define GREEDY_H
+#include "structs.h"
+#include "territory.h"
+#include <stdbool.h>
+
+// Motor de un movimiento del jugador (greedy y territory): cada vecino libre se puntua por su
+// recompensa, la cercania al centro y la movilidad que deja
+int evaluate_cell(const board_t* board, int x, int y, int free_neighbors);
+// Con territory (ya preparado para este turno) cada candidato suma el valor de su territorio.
+// Devuelve la direccion o -1 si no hay movimiento.
+signed char calculate_move(const board_t* board, int x, int y, bool blocked, territory_t* territory);
+
+#endif
@@ -7,12 +7,23 @@
 #include <stdbool.h>
 
 // memoria compartida
-int create_shared_memory(const char* name, size_t size);
+// Los nombres base (GAME_STATE_SHM, ...) se resuelven con el sufijo de GAME_ID_ENV si esta definido
+const char* shm_name(const char* base, char* buffer, size_t size);
+bool is_valid_game_id(const char* game_id);
+size_t game_state_board_offset(int player_count);
+size_t game_state_free_offset(int width, int height, int player_count, unsigned char cell_bytes);
+size_t game_state_delta_offset(int width, int height, int player_count, unsigned char cell_bytes);
+size_t game_state_size(int width, int height, int player_count, unsigned char cell_bytes);
+size_t game_sync_size(int player_count);
+// Encabezado, jugadores, tablero (con la semilla) y posiciones iniciales sobre memoria en cero de
+// game_state_size bytes; lo usan el máster y el reproductor de replays
+void initialize_game_state(game_state_t* state, int width, int height, int player_count, unsigned char cell_bytes, unsigned int seed);
+int create_shared_memory(const char* base_name, size_t size);
 void *attach_shared_memory(int shm_fd, size_t size, bool read_only);
 void detach_shared_memory(void* addr, size_t size);
 void cleanup_shared_memory(game_state_t* gamestate, game_sync_t* gamesync);
-void clear_shm(const char* name);
-int connect_to_shared_memory(const char* name, bool read_only);
+void clear_shm(const char* base_name);
+int connect_to_shared_memory(const char* base_name, bool read_only);
 game_state_t* setup_game_state(int width, int height);
 game_sync_t* setup_game_sync();
 
@@ -20,6 +31,19 @@ game_sync_t* setup_game_sync();
 void initialize_semaphores(game_sync_t* sync, int player_count);
 void cleanup_semaphores(game_sync_t* sync, int player_count);
 
+// lectores-escritores con semaforos (protocolo original, lo usan lectores externos)
+void reader_enter(game_sync_t* sync);
+void reader_exit(game_sync_t* sync);
+void writer_enter(game_sync_t* sync);
+void writer_exit(game_sync_t* sync);
+
+// seqlock: el máster nunca espera a los lectores; el lector reintenta si la lectura quedo partida
+void state_write_begin(game_state_t* state);
+void state_write_end(game_state_t* state);
+unsigned int state_read_begin(const game_state_t* state);
+bool state_read_retry(const game_state_t* state, unsigned int start);
+void read_state_snapshot(const game_state_t* shared, game_state_t* local); // copia consistente de todo el segmento
+
 // funciones auxiliares
 int is_executable_file(const char *path);
 
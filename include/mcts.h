@@ -0,0 +1,76 @@
+#ifndef MCTS_H
+#define MCTS_H
+#include "structs.h"
+#include "search.h"
+#include <pthread.h>
+#include <stdint.h>
+
+#define MCTS_MAX_NODES (1 << 16) // Nodos por arbol (uno por hilo)
+#define MCTS_HORIZON_ROUNDS 24 // Rondas simuladas desde la raiz (arbol + playout)
+#define MCTS_EXPLORATION 1.4 // Constante de exploracion de UCT
+#define MCTS_CLOCK_CHECK_ITERATIONS 16 // Iteraciones entre consultas al reloj
+#define MAX_MCTS_THREADS 64 // Tope de -j
+#define MCTS_DEFAULT_MAX_THREADS 8 // Tope del default de -j (cada hilo tiene su copia del tablero)
+#define MCTS_PENDING_CELLS 4096 // Celdas cambiadas que se acumulan para los hilos; con mas se copia el tablero
+#define MCTS_MAX_PLAYERS (1 + SEARCH_MAX_OPPONENTS) // El jugador y sus rivales cercanos (ver select_opponents)
+
+typedef struct {
+    int first_child; // Indice del primer hijo (-1 sin expandir)
+    unsigned char child_count;
+    unsigned char move; // Direccion que llevo a este nodo (NUM_DIRECTIONS = pasar)
+    unsigned char mover; // Indice (en el orden de la busqueda) de quien mueve en este nodo
+    unsigned int visits;
+    double reward; // Suma de recompensas de quien jugo `move`
+} mcts_node_t;
+
+struct mcts;
+
+// Estado de un hilo: su copia del tablero, su arbol y su generador xorshift
+typedef struct {
+    struct mcts* owner;
+    pthread_t thread;
+    bool started; // El hilo existe (el worker 0 es el hilo principal)
+    board_t board; // Igual al tablero del jugador entre movimientos: cada simulacion deshace lo suyo
+    mcts_node_t* nodes;
+    int node_count;
+    uint64_t rng;
+    unsigned int root_visits[NUM_DIRECTIONS]; // Resultado del hilo por movimiento de la raiz
+    unsigned long iterations;
+} mcts_worker_t;
+
+// MCTS con paralelismo de raiz: cada hilo arma su propio arbol (UCT max^n, cada jugador
+// maximiza su recompensa) y al vencer el deadline se suman las visitas de la raiz. Los hilos
+// viven toda la partida y se despiertan una vez por movimiento (round).
+typedef struct mcts {
+    int threads;
+    mcts_worker_t* workers;
+    pthread_mutex_t lock;
+    pthread_cond_t start; // Empieza una vuelta (o stop)
+    pthread_cond_t done; // Termino el ultimo hilo de la vuelta
+    unsigned long round;
+    int running; // Hilos que todavia no terminaron la vuelta
+    bool stop;
+    // Celdas del tablero del jugador que cambiaron desde la ultima busqueda
+    unsigned int* pending;
+    size_t pending_count;
+    bool pending_full; // Hay que copiar el tablero entero
+    // Entrada del turno actual (solo lectura para los hilos)
+    const board_t* source;
+    int count;
+    int id[MCTS_MAX_PLAYERS];
+    int x[MCTS_MAX_PLAYERS];
+    int y[MCTS_MAX_PLAYERS];
+    uint64_t deadline_ns;
+} mcts_t;
+
+// Hilos por defecto: los cores que permite la afinidad del proceso, a lo sumo MCTS_DEFAULT_MAX_THREADS
+int mcts_default_threads(void);
+int mcts_init(mcts_t* mcts, const board_t* board, int threads);
+// Anota lo que cambio en el tablero del jugador este turno (changed de snapshot_update o
+// full_copy); hay que llamarla todos los turnos, se busque o no
+void mcts_observe(mcts_t* mcts, const unsigned int* changed, size_t count, bool full_copy);
+// Devuelve la direccion mas visitada o -1 si no hay movimientos
+signed char mcts_move(mcts_t* mcts, const board_t* board, const player_t* players, unsigned int player_count, int me, uint64_t deadline_ns);
+void mcts_free(mcts_t* mcts);
+
+#endif
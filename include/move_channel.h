@@ -0,0 +1,59 @@
+#ifndef MOVE_CHANNEL_H
+#define MOVE_CHANNEL_H
+#include "structs.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define GAME_MOVES_SHM "/game_moves"
+#define TRANSPORT_ENV "CHOMPCHAMPS_TRANSPORT" // "shm" si la partida usa anillos; sin definir: pipes
+#define TRANSPORT_SHM "shm"
+#define MOVE_RING_SIZE 64 // Movimientos por anillo (potencia de dos); en juego hay a lo sumo uno pendiente
+#define MOVE_CHANNEL_SPIN_ITERATIONS 4000 // Vueltas de espera activa antes de dormir en el futex (con mas de un core)
+#define MOVE_CHANNEL_LIVENESS_MS 50 // Cada cuanto el máster dormido revisa si un jugador murio sin avisar
+
+// Canal de un jugador: anillo de un productor (el jugador) y un consumidor (el máster), con el
+// turno como contador que hace de futex. Productor y consumidor escriben en lineas de cache
+// distintas. alive reemplaza al EOF del pipe: el máster lo pone en 1 antes del fork y el jugador
+// (o el máster al recolectarlo) lo pone en 0 al terminar.
+typedef struct {
+    uint32_t head; // Movimientos escritos (solo el jugador)
+    uint32_t player_waiting; // El jugador duerme en turn
+    uint8_t producer_pad[SHM_ALIGNMENT - 2 * sizeof(uint32_t)];
+    uint32_t tail; // Movimientos leidos (solo el máster)
+    uint32_t turn; // Turnos otorgados (solo el máster); el jugador duerme en este futex
+    uint32_t alive;
+    uint8_t consumer_pad[SHM_ALIGNMENT - 3 * sizeof(uint32_t)];
+    unsigned char ring[MOVE_RING_SIZE];
+} move_channel_t;
+
+// Segmento /game_moves: [encabezado | move_channel_t[player_count]]
+typedef struct {
+    uint32_t player_count;
+    uint32_t posted; // Movimientos publicados por cualquier jugador: el máster duerme en este futex
+    uint32_t master_waiting; // El máster duerme en posted
+    uint32_t spin_iterations; // 0 con un solo core: esperar activo solo le quita tiempo al otro lado
+    uint8_t pad[SHM_ALIGNMENT - 4 * sizeof(uint32_t)];
+    move_channel_t channels[];
+} move_channels_t;
+
+bool transport_is_shm(void); // TRANSPORT_ENV pide anillos
+size_t move_channels_size(int player_count);
+void move_channels_init(move_channels_t* channels, int player_count);
+
+// Máster
+void move_channel_post_turn(move_channels_t* channels, int id);
+bool move_channel_pop(move_channels_t* channels, int id, unsigned char* move); // false si el anillo esta vacio
+bool move_channel_pending(const move_channels_t* channels, int id);
+// Espera a que algun jugador publique algo desde que se leyo `seen` de channels->posted, a lo sumo
+// timeout_ns. Devuelve false si vencio el tiempo.
+bool move_channels_wait(move_channels_t* channels, uint32_t seen, uint64_t timeout_ns);
+void move_channel_mark_dead(move_channels_t* channels, int id);
+
+// Jugador
+move_channels_t* move_channels_connect(void); // Con TRANSPORT_ENV en shm; NULL si no
+void move_channel_wait_turn(move_channels_t* channels, int id, uint32_t* turns); // turns: turnos ya usados
+void move_channel_push(move_channels_t* channels, int id, unsigned char move);
+void move_channel_close(move_channels_t* channels, int id); // El jugador termina: alive = 0
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef REPLAY_ENGINE_H
+#define REPLAY_ENGINE_H
+#include "structs.h"
+#include "replay_log.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define REPLAY_KEYFRAME_INTERVAL 1024 // Movimientos entre keyframes por defecto
+#define REPLAY_KEYFRAME_MAX_MB 256 // Tope de memoria de los keyframes: al pasarlo se duplica el intervalo
+
+// Reconstruye una partida sobre un game_state (local o compartido) con las mismas funciones que
+// el máster. Cada `interval` movimientos guarda un keyframe (jugadores, tablero y plano de
+// libres), asi que ir al movimiento N cuesta a lo sumo un intervalo de movimientos y no N.
+typedef struct {
+    const replay_file_t* file;
+    game_state_t* state;
+    size_t position; // Registros aplicados
+    size_t interval; // 0: solo el estado inicial
+    unsigned char* keyframes; // keyframe k = estado tras k * interval registros
+    size_t keyframe_count;
+    size_t keyframe_capacity;
+    size_t keyframe_offset; // Se copia desde los jugadores hasta el anillo de deltas (excluido)
+    size_t keyframe_bytes;
+    size_t checked; // Registros ya comparados con el log (al volver atras no se cuentan de nuevo)
+    size_t mismatches; // Registros cuya validez no coincide con la del log
+} replay_engine_t;
+
+// state debe tener game_state_size bytes en cero (alineado a SHM_ALIGNMENT)
+int replay_engine_init(replay_engine_t* engine, const replay_file_t* file, game_state_t* state, size_t interval);
+void replay_engine_free(replay_engine_t* engine);
+// Aplica el proximo registro; devuelve false si ya no quedan
+bool replay_engine_step(replay_engine_t* engine);
+// Deja el estado tras `position` registros (o el final): keyframe mas cercano y lo que falta
+void replay_engine_seek(replay_engine_t* engine, size_t position);
+// Tras aplicar todo el log: compara los resultados con su cierre (sin cierre solo la validez)
+bool replay_engine_matches(const replay_engine_t* engine);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+#include "structs.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define REPLAY_MAGIC "CCRP" // Comienzo del archivo
+#define REPLAY_FOOTER_MAGIC "CCRE" // Cierre escrito al terminar la partida
+#define REPLAY_FORMAT_VERSION 2 // 2: REPLAY_DEADLINE_MISSED
+#define REPLAY_MIN_FORMAT_VERSION 1 // Versiones anteriores que se siguen pudiendo leer
+#define REPLAY_RING_RECORDS 65536 // Registros en memoria entre el bucle del juego y el escritor (potencia de dos, 1 MiB)
+#define REPLAY_FLUSH_RECORDS 4096 // Pendientes con los que se despierta al escritor antes de tiempo
+#define REPLAY_FLUSH_INTERVAL_MS 50 // Espera maxima del escritor entre vaciados
+#define REPLAY_FULL_WAIT_US 100 // Espera del máster si el anillo se llena (el disco no da abasto)
+
+enum ReplayRecordFlags {
+    REPLAY_MOVE_VALID = 1 << 0, // El movimiento se aplico
+    REPLAY_PLAYER_LEFT = 1 << 1, // El jugador queda fuera: pipe cerrado o presupuestos vencidos (move no se usa)
+    REPLAY_DEADLINE_MISSED = 1 << 2 // Vencio su presupuesto (--budget): turno invalido, move no se usa
+};
+
+// Archivo (orden de bytes nativo): [replay_header_t | nombres (player_count x MAX_NAME_LENGTH) |
+// replay_record_t... | replay_result_t[player_count] | replay_footer_t]. El tablero y las
+// posiciones iniciales salen de initialize_board/place_players_on_board con la semilla, asi que
+// los movimientos alcanzan para reconstruir la partida. Sin cierre (el máster murio) valen los
+// registros completos.
+typedef struct {
+    char magic[4]; // REPLAY_MAGIC
+    uint32_t version; // REPLAY_FORMAT_VERSION
+    uint32_t seed;
+    uint16_t width;
+    uint16_t height;
+    uint16_t player_count;
+    uint8_t cell_bytes; // Ancho de celda del tablero original (--compact)
+    uint8_t reserved[5]; // Relleno explicito: started_at queda alineado sin huecos del compilador
+    int64_t started_at; // Inicio de la partida en segundos desde epoch (solo informativo)
+} replay_header_t;
+
+typedef struct {
+    uint64_t time_ns; // Desde el inicio del log (reloj monotonico)
+    uint16_t player;
+    uint8_t move; // Byte leido del pipe, tal cual
+    uint8_t flags; // ReplayRecordFlags
+    uint32_t reserved;
+} replay_record_t;
+
+typedef struct {
+    uint32_t score;
+    uint32_t valid_moves;
+    uint32_t invalid_moves;
+} replay_result_t;
+
+typedef struct {
+    char magic[4]; // REPLAY_FOOTER_MAGIC
+    uint32_t player_count;
+    uint64_t record_count;
+    uint64_t duration_ns;
+} replay_footer_t;
+
+// Escritor en segundo plano: el bucle del juego copia cada registro a un anillo en memoria y un
+// hilo lo vuelca al archivo por tandas, asi que ningun movimiento espera una escritura a disco
+typedef struct {
+    int fd;
+    replay_record_t* ring;
+    size_t head; // Proximo registro a escribir en el anillo (solo el máster)
+    size_t tail; // Proximo registro a volcar al archivo (solo el escritor)
+    uint64_t start_ns;
+    uint64_t records;
+    bool failed; // Fallo una escritura: lo que sigue se descarta
+    bool stop;
+    bool started;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+} replay_log_t;
+
+// Replay abierto para leer (mapeado en memoria, solo lectura)
+typedef struct {
+    replay_header_t header;
+    const char* names; // player_count x MAX_NAME_LENGTH
+    const replay_record_t* records;
+    size_t record_count;
+    const replay_result_t* results; // Resultados del cierre o NULL si el archivo quedo sin cierre
+    replay_footer_t footer;
+    void* map;
+    size_t map_size;
+} replay_file_t;
+
+// Valida encabezado y cierre; un archivo sin cierre se lee hasta el ultimo registro completo
+int replay_file_open(replay_file_t* file, const char* path);
+void replay_file_close(replay_file_t* file);
+
+// Crea el archivo, escribe el encabezado con el estado recien inicializado y arranca el escritor
+int replay_log_open(replay_log_t* log, const char* path, const game_state_t* state, unsigned int seed);
+// Encola un movimiento procesado (no bloquea salvo que el anillo este lleno)
+void replay_log_move(replay_log_t* log, int player, unsigned char move, unsigned char flags, uint64_t now_ns);
+// Vacia lo pendiente, escribe el cierre con los resultados de state y cierra el archivo
+int replay_log_close(replay_log_t* log, const game_state_t* state);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+#include "structs.h"
+#include "ttable.h"
+#include <stdint.h>
+
+#define SEARCH_MAX_OPPONENTS 3 // Rivales cercanos que entran en la busqueda
+#define SEARCH_OPPONENT_RADIUS 8 // Distancia (Chebyshev) maxima para considerar a un rival
+#define SEARCH_MAX_ROUNDS 64 // Profundidad maxima en rondas (una ronda = un movimiento de cada uno)
+#define SEARCH_CLOCK_CHECK_NODES 256 // Nodos entre consultas al reloj
+#define SEARCH_GAIN_WEIGHT 10 // Peso de cada punto capturado
+#define SEARCH_MOBILITY_WEIGHT 4 // Peso de cada movimiento disponible en las hojas
+#define SEARCH_REGION_WEIGHT 2 // Peso de cada punto alcanzable desde la celda elegida en la raiz
+#define SEARCH_REGION_MAX_CELLS 4096 // Tope del relleno de la raiz: distingue bolsillos sin recorrer todo el tablero
+#define SEARCH_BLOCKED_PENALTY 100000 // Quedar bloqueado (mas cuanto antes ocurra)
+#define SEARCH_DEFAULT_BUDGET_MS 5 // Tiempo por movimiento del motor de busqueda
+
+// Rivales no bloqueados a SEARCH_OPPONENT_RADIUS o menos (los SEARCH_MAX_OPPONENTS mas cercanos),
+// en el orden en que mueven despues de `me`. Devuelve cuantos escribio en opponents.
+int select_opponents(const player_t* players, unsigned int player_count, int me, int* opponents);
+
+// Busqueda paranoica con poda alfa-beta y profundizacion iterativa: el jugador maximiza y los
+// rivales cercanos, en su orden de turno, minimizan. Mueve y deshace sobre board (la copia local
+// del jugador, que queda igual al terminar) y corta al llegar a deadline_ns (monotonic_ns).
+// Con table, las posiciones ya vistas (en este turno o en los anteriores) se toman de la tabla de
+// transposicion; board_hash es zobrist_board del tablero, que el llamador mantiene entre turnos.
+// Devuelve la direccion elegida o -1 si no hay movimientos.
+signed char search_move(board_t* board, const player_t* players, unsigned int player_count, int me, uint64_t deadline_ns, ttable_t* table, uint64_t board_hash);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include "structs.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+// Copia local del estado que se mantiene al dia aplicando solo los deltas publicados
+// por el máster desde la ultima actualizacion. Si el lector quedo mas atras que el
+// anillo (o el estado no tiene anillo) se copia el tablero completo.
+typedef struct {
+    int width;
+    int height;
+    unsigned int player_count;
+    bool is_game_over;
+    board_t board; // Tablero local, mismo ancho de celda que el compartido
+    player_t* players; // Tabla de jugadores local
+    unsigned long long version; // Ultimo delta aplicado
+    bool synced; // Ya se hizo la primera copia completa
+    bool full_copy; // La ultima actualizacion copio el tablero entero
+    unsigned int* changed; // Celdas modificadas por la ultima actualizacion (si !full_copy)
+    size_t changed_count;
+    board_delta_t* pending; // Deltas leidos bajo el seqlock, se aplican una vez validados
+} state_snapshot_t;
+
+int snapshot_init(state_snapshot_t* snapshot, const game_state_t* shared);
+void snapshot_update(state_snapshot_t* snapshot, const game_state_t* shared);
+void snapshot_free(state_snapshot_t* snapshot);
+
+#endif
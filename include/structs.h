@@ -1,9 +1,14 @@
 #ifndef STRUCTS_H
 #define STRUCTS_H
 
-#define MAX_PLAYERS 9
+#define MAX_PLAYERS 256 // Limite de jugadores aceptado por el master en tiempo de ejecucion
+#define PRESET_POSITIONS 9 // Cantidad de posiciones iniciales predefinidas
+#define PLAYER_COLOR_COUNT 9 // Cantidad de colores distintos para jugadores en la vista
 #define GAME_STATE_SHM "/game_state"
 #define GAME_SYNC_SHM "/game_sync"
+#define GAME_ID_ENV "CHOMPCHAMPS_GAME_ID" // Sufijo de los segmentos de la partida, heredado por jugadores y vista
+#define GAME_ID_MAX_LENGTH 32
+#define SHM_NAME_MAX_LENGTH 64
 #define MAX_NAME_LENGTH 16
 
 #define NUM_DIRECTIONS 8
@@ -26,18 +31,28 @@
 
 
 #define ARG_BUFFER_SIZE 16
+#define PLAYER_SPEC_MAX_LENGTH 256 // "ruta [opciones...]" de un jugador en -p
+#define MAX_PLAYER_ARGS 16 // Opciones propias del jugador despues de ancho y alto
 
 #define FINAL_VIEW_DISPLAY_MS 6000
-#define VIEW_WAIT_TIMEOUT_SEC 2
+#define VIEW_INPUT_POLL_MS 100 // Espera maxima de la vista entre lecturas del teclado
+#define VIEW_DEFAULT_FPS 30 // Cuadros por segundo del espectador si no se indica --fps
+#define VIEW_MAX_FPS 240
+#define VIEW_FOLLOW_MARGIN 3 // Celdas hasta el borde de la ventana antes de recentrar al jugador seguido
+#define VIEW_SCROLL_FRACTION 4 // Cada flecha desplaza 1/4 de la ventana de detalle
+#define VIEW_OVERVIEW_BRIGHT_VALUE 5 // Valor libre promedio desde el que un bloque del resumen se resalta
 
 #define MS_TO_SEC 1000
 #define MS_TO_NS 1000000L
+#define US_TO_NS 1000L
 #define NS_PER_SEC 1000000000L
 
 #define GRACEFUL_TERMINATION_WAIT_SEC 1
 
 #define MOVE_DATA_SIZE 1
 
+#define SUMMARY_PREFIX "summary" // Prefijo de las lineas de --summary: summary,jugador,puntaje,validos,invalidos,ganador
+
 #define PLAYER_POSITION_MARGIN 1
 #define PLAYER_POSITION_OFFSET 2
 
@@ -68,6 +83,18 @@
 #define WINNER_POPUP_BORDER 4
 #define VIEW_REFRESH_DELAY_MS 1200
 
+#define GAME_STATE_LAYOUT_VERSION 8 // Version del layout de /game_state (8: jugadores dinamicos, seqlock, log de deltas, celdas compactas, plano de libres, tablero con borde y contador de cuadros)
+#define SHM_ALIGNMENT 64 // Alineacion (linea de cache) de las regiones dentro de la memoria compartida
+
+#define COMPACT_CELL_BYTES 1 // Tablero compacto (--compact): una celda = int8_t
+#define MAX_COMPACT_PLAYERS 127 // Dueños -1..-127 entran en un int8_t
+#define BOARD_BORDER 1 // Anillo de celdas en 0 (ocupadas) alrededor del tablero
+#define BOARD_ROW_ALIGN_MIN_BYTES 256 // Filas de al menos este tamaño se redondean a SHM_ALIGNMENT
+#define FREE_PLANE_WORD_BITS 64 // Bits por palabra del plano de celdas libres
+#define FREE_PLANE_GUARD_WORDS 8 // Palabras en cero antes y despues del plano (window3 puede leer una palabra de mas)
+#define DELTA_LOG_CAPACITY 4096 // Movimientos aplicados que conserva el anillo de deltas
+#define SEQLOCK_SPIN_LIMIT 64 // Reintentos activos del lector antes de ceder el procesador
+
 #define SHM_PERMISSIONS 0644
 #define SHM_CONNECT_PERMISSIONS 0
 
@@ -84,6 +111,8 @@ enum ErrorCodes {
 #include <sys/types.h>
 #include <semaphore.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 
 typedef struct {
     char name[MAX_NAME_LENGTH]; // Nombre del jugador
@@ -95,13 +124,33 @@ typedef struct {
     bool blocked; // Indica si el jugador está bloqueado
 } player_t;
 
+// Movimiento aplicado por el máster, tal como lo ven los lectores incrementales
 typedef struct {
+    unsigned int cell; // Indice de la celda capturada (y * width + x)
+    int owner; // Nuevo valor de la celda: -(jugador + PLAYER_ID_OFFSET)
+    unsigned short player; // Jugador que se movio
+    unsigned short x, y; // Su nueva posicion
+} board_delta_t;
+
+// Layout de /game_state: [encabezado | players[player_count] | tablero | plano de libres | anillo de deltas]
+// (cada region alineada a SHM_ALIGNMENT)
+typedef struct {
+    unsigned int layout_version; // Version del layout (GAME_STATE_LAYOUT_VERSION)
     unsigned short width; // Ancho del tablero
     unsigned short height; // Alto del tablero
     unsigned int player_count; // Cantidad de jugadores
-    player_t players[MAX_PLAYERS]; // Lista de jugadores
     bool is_game_over; // Indica si el juego se ha terminado
-    int board[]; // Puntero al comienzo del tablero. fila-0, fila-1, ..., fila-n-1
+    unsigned char cell_bytes; // Bytes por celda: sizeof(int) o COMPACT_CELL_BYTES
+    unsigned int state_seq; // Seqlock: impar mientras el máster escribe, se incrementa en cada escritura
+    size_t board_offset; // Desplazamiento en bytes del tablero (incluido su borde) desde el comienzo del estado
+    unsigned int board_stride; // Celdas por fila del tablero: ancho + borde + relleno de alineacion
+    size_t free_offset; // Desplazamiento del plano de celdas libres (0: sin plano)
+    size_t delta_offset; // Desplazamiento en bytes del anillo de deltas
+    unsigned int delta_capacity; // Entradas del anillo (0: sin log de deltas)
+    unsigned long long delta_version; // Cantidad de deltas publicados; el k-esimo esta en (k - 1) % delta_capacity
+    unsigned long long frame; // Escrituras publicadas: los espectadores solo redibujan si cambio
+    size_t total_size; // Tamaño total del segmento
+    player_t players[]; // Lista de jugadores (player_count elementos)
 } game_state_t;
 
 typedef struct {
@@ -111,7 +160,8 @@ typedef struct {
     sem_t state_mutex; // Mutex para el estado del juego
     sem_t reader_count_mutex; // Mutex para la siguiente variable
     unsigned int readers_count; // Cantidad de jugadores leyendo el estado
-    sem_t player_turn[MAX_PLAYERS]; // Le indican a cada jugador que puede enviar 1 movimiento
+    unsigned int player_count; // Cantidad de semaforos en player_turn
+    sem_t player_turn[]; // Le indican a cada jugador que puede enviar 1 movimiento
 } game_sync_t;
 
 typedef enum {
@@ -127,4 +177,45 @@ typedef enum {
 
 extern const int MOVE_DELTAS[NUM_DIRECTIONS][2];
 
+// Vista local de un tablero (en memoria compartida o una copia del jugador/vista).
+// Las celdas son int o int8_t segun cell_bytes; se acceden con las funciones de game_functions.h
+// Cada fila ocupa stride celdas y el tablero esta rodeado por un borde de BOARD_BORDER celdas
+// en 0: (x, y) con -1 <= x <= width y -1 <= y <= height se puede leer sin chequear limites
+// El plano de libres guarda un bit por celda (1 = libre) con un borde de una celda en cero
+// alrededor del tablero: la celda (x, y) es el bit x + 1 de la fila y + 1 (ver bitboard.h)
+typedef struct {
+    void* cells; // borde superior, fila-0, fila-1, ..., fila-n-1, borde inferior
+    int width;
+    int height;
+    int stride; // Celdas por fila (incluye el borde)
+    unsigned char cell_bytes;
+    uint64_t* free_bits; // Fila 0 del plano de libres (la del borde superior), NULL si no hay plano
+    size_t free_stride; // Palabras por fila del plano
+} board_t;
+
+static inline size_t free_plane_stride(int width) {
+    return ((size_t)width + 2 + FREE_PLANE_WORD_BITS - 1) / FREE_PLANE_WORD_BITS;
+}
+
+// Celdas por fila con borde; las filas largas se redondean a una linea de cache
+static inline int board_row_stride(int width, unsigned char cell_bytes) {
+    int stride = width + 2 * BOARD_BORDER;
+    if ((size_t)stride * cell_bytes >= BOARD_ROW_ALIGN_MIN_BYTES) {
+        int cells_per_line = SHM_ALIGNMENT / cell_bytes;
+        stride = (stride + cells_per_line - 1) / cells_per_line * cells_per_line;
+    }
+    return stride;
+}
+
+static inline board_t game_board(const game_state_t* state) {
+    board_t board = { (char*)state + state->board_offset, state->width, state->height, (int)state->board_stride, state->cell_bytes,
+                      state->free_offset ? (uint64_t*)((char*)state + state->free_offset) + FREE_PLANE_GUARD_WORDS : NULL,
+                      free_plane_stride(state->width) };
+    return board;
+}
+
+static inline board_delta_t* game_deltas(const game_state_t* state) {
+    return (board_delta_t*)((char*)state + state->delta_offset);
+}
+
 #endif // STRUCTS_H
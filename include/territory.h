@@ -0,0 +1,35 @@
+#ifndef TERRITORY_H
+#define TERRITORY_H
+#include "structs.h"
+
+#define TERRITORY_RADIUS 24 // Profundidad maxima de los BFS (en movimientos)
+#define TERRITORY_VALUE_WEIGHT 1 // Peso de cada punto de territorio en calculate_move
+
+// Territorio tipo Voronoi: celdas a las que el jugador llega antes que cualquier rival.
+// Los arreglos se reservan una vez y se marcan con un contador de generacion, asi que ningun
+// BFS limpia ni reserva memoria. Las distancias de los rivales se calculan una vez por turno y
+// cada candidato solo recorre las celdas que gana (se poda donde un rival llega igual o antes).
+typedef struct {
+    int width;
+    int height;
+    unsigned int generation;
+    unsigned int* opponent_stamp; // Generacion en la que se escribio opponent_dist
+    unsigned short* opponent_dist;
+    unsigned int* own_stamp; // Celdas ya visitadas por el BFS del candidato actual
+    int* queue;
+    unsigned int opponent_generation; // Generacion del ultimo territory_prepare
+} territory_t;
+
+typedef struct {
+    int cells; // Celdas ganadas
+    int value; // Suma de sus recompensas
+} territory_result_t;
+
+int territory_init(territory_t* territory, int width, int height);
+void territory_free(territory_t* territory);
+// BFS multi-origen desde los rivales no bloqueados que pueden disputar el radio de `me`
+void territory_prepare(territory_t* territory, const board_t* board, const player_t* players, unsigned int player_count, int me);
+// Territorio si el jugador se mueve a la celda libre (x, y)
+territory_result_t territory_measure(territory_t* territory, const board_t* board, int x, int y);
+
+#endif
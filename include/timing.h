@@ -0,0 +1,11 @@
+#ifndef TIMING_H
+#define TIMING_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Reloj monotonico de alta resolucion (CLOCK_MONOTONIC) en nanosegundos
+uint64_t monotonic_ns(void);
+// Ordena las muestras y devuelve el percentil pedido (0-100). Devuelve 0 si no hay muestras.
+uint64_t percentile_ns(uint64_t* samples, size_t count, unsigned int percentile);
+
+#endif
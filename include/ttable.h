@@ -0,0 +1,79 @@
+#ifndef TTABLE_H
+#define TTABLE_H
+#include "structs.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define TT_DEFAULT_MEGABYTES 16 // Tope de memoria de la tabla por defecto (-t)
+#define TT_MAX_MEGABYTES 4096 // Tope aceptado por -t
+#define TT_BUCKET_ENTRIES 4 // Entradas por bucket: 4 x 16 bytes = una linea de cache
+#define TT_CACHE_LINE_BYTES 64
+#define TT_AGE_WEIGHT 4 // Plies de profundidad que vale cada turno de antiguedad al reemplazar
+#define TT_NO_MOVE 0xFF
+
+enum TTBound {
+    TT_BOUND_NONE = 0,
+    TT_BOUND_EXACT,
+    TT_BOUND_LOWER, // El valor real es >= score (corte beta)
+    TT_BOUND_UPPER  // El valor real es <= score (ningun movimiento supero alfa)
+};
+
+typedef struct {
+    uint64_t key; // Clave Zobrist completa (0 = entrada vacia)
+    int32_t score;
+    uint8_t depth; // Plies que quedaban al guardar
+    uint8_t bound;
+    uint8_t move; // Mejor movimiento encontrado o TT_NO_MOVE
+    uint8_t generation; // Turno en que se escribio
+} tt_entry_t;
+
+typedef struct {
+    tt_entry_t entries[TT_BUCKET_ENTRIES];
+} tt_bucket_t;
+
+// Tabla de transposicion de tamaño fijo (potencia de dos de buckets alineados a linea de
+// cache). Vive todo el partido: cada turno solo avanza la generacion, asi que lo buscado
+// en el turno anterior se sigue usando y lo viejo es lo primero que se reemplaza.
+typedef struct {
+    tt_bucket_t* buckets;
+    size_t mask; // Cantidad de buckets - 1
+    uint8_t generation;
+} ttable_t;
+
+// Claves Zobrist calculadas al vuelo (splitmix64 de la celda y el dueño): con hasta
+// MAX_PLAYERS dueños por celda una tabla aleatoria completa no entra en cache
+static inline uint64_t zobrist_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Celda (y * width + x) capturada por owner
+static inline uint64_t zobrist_cell(unsigned int cell, unsigned int owner) {
+    return zobrist_mix(((uint64_t)cell << 10) | ((uint64_t)owner << 2) | 0);
+}
+
+// Jugador id parado en la celda, ocupando el lugar slot del orden de la busqueda
+static inline uint64_t zobrist_player(unsigned int slot, unsigned int player, unsigned int cell) {
+    return zobrist_mix(((uint64_t)cell << 20) | ((uint64_t)slot << 12) | ((uint64_t)player << 2) | 1);
+}
+
+// Le toca mover al lugar slot
+static inline uint64_t zobrist_turn(unsigned int slot) {
+    return zobrist_mix(((uint64_t)slot << 2) | 2);
+}
+
+// Hash de todas las celdas capturadas del tablero
+uint64_t zobrist_board(const board_t* board);
+
+// Reserva la mayor tabla que entra en megabytes (0 deja la tabla vacia y desactivada)
+int ttable_init(ttable_t* table, size_t megabytes);
+void ttable_free(ttable_t* table);
+// Empieza un turno nuevo: las entradas anteriores siguen validas pero envejecen
+void ttable_new_turn(ttable_t* table);
+// Devuelve la entrada con esa clave o NULL
+const tt_entry_t* ttable_probe(const ttable_t* table, uint64_t key);
+void ttable_store(ttable_t* table, uint64_t key, int depth, int bound, int score, int move);
+
+#endif
@@ -0,0 +1,92 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/bitboard.h"
+#include "../include/game_functions.h"
+#include <stdlib.h>
+#include <string.h>
+
+size_t free_plane_words(int width, int height) {
+    return (size_t)(height + 2) * free_plane_stride(width) + 2 * FREE_PLANE_GUARD_WORDS;
+}
+
+size_t free_plane_bytes(int width, int height) {
+    return free_plane_words(width, height) * sizeof(uint64_t);
+}
+
+uint64_t* free_plane_alloc(int width, int height) {
+    uint64_t* bits = calloc(free_plane_words(width, height), sizeof(uint64_t));
+    return bits ? bits + FREE_PLANE_GUARD_WORDS : NULL;
+}
+
+void free_plane_release(uint64_t* bits) {
+    if (bits) {
+        free(bits - FREE_PLANE_GUARD_WORDS);
+    }
+}
+
+static inline void set_plane_bit(uint64_t* row, int px, bool free) {
+    uint64_t bit = (uint64_t)1 << (px % FREE_PLANE_WORD_BITS);
+    if (free) {
+        row[px / FREE_PLANE_WORD_BITS] |= bit;
+    } else {
+        row[px / FREE_PLANE_WORD_BITS] &= ~bit;
+    }
+}
+
+void free_plane_build(board_t* board) {
+    if (!board->free_bits) {
+        return;
+    }
+    memset(board->free_bits, 0, (size_t)(board->height + 2) * board->free_stride * sizeof(uint64_t));
+    for (int y = 0; y < board->height; y++) {
+        uint64_t* row = board->free_bits + (size_t)(y + 1) * board->free_stride;
+        for (int x = 0; x < board->width; x++) {
+            if (board_cell(board, x, y) > 0) {
+                set_plane_bit(row, x + 1, true);
+            }
+        }
+    }
+}
+
+void free_plane_update(board_t* board, int x, int y, int value) {
+    if (!board->free_bits) {
+        return;
+    }
+    set_plane_bit(board->free_bits + (size_t)(y + 1) * board->free_stride, x + 1, value > 0);
+}
+
+// Bits de las columnas px - 1, px, px + 1 de una fila del plano (bit 0 = px - 1)
+static inline unsigned int window3(const uint64_t* row, int px) {
+    int lo = px - 1;
+    int shift = lo % FREE_PLANE_WORD_BITS;
+    uint64_t bits = row[lo / FREE_PLANE_WORD_BITS] >> shift;
+    if (shift > FREE_PLANE_WORD_BITS - 3) {
+        bits |= row[lo / FREE_PLANE_WORD_BITS + 1] << (FREE_PLANE_WORD_BITS - shift);
+    }
+    return (unsigned int)bits & 7u;
+}
+
+unsigned char legal_move_mask(const board_t* board, int x, int y) {
+    unsigned char mask = 0;
+    if (!board->free_bits) {
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            if (is_cell_free(board, x + MOVE_DELTAS[d][0], y + MOVE_DELTAS[d][1])) {
+                mask |= (unsigned char)(1u << d);
+            }
+        }
+        return mask;
+    }
+    const uint64_t* mid = board->free_bits + (size_t)(y + 1) * board->free_stride;
+    unsigned int up = window3(mid - board->free_stride, x + 1);
+    unsigned int row = window3(mid, x + 1);
+    unsigned int down = window3(mid + board->free_stride, x + 1);
+
+    mask |= ((up >> 1) & 1u) << MOVE_UP;
+    mask |= ((up >> 2) & 1u) << MOVE_UP_RIGHT;
+    mask |= ((row >> 2) & 1u) << MOVE_RIGHT;
+    mask |= ((down >> 2) & 1u) << MOVE_DOWN_RIGHT;
+    mask |= ((down >> 1) & 1u) << MOVE_DOWN;
+    mask |= (down & 1u) << MOVE_DOWN_LEFT;
+    mask |= (row & 1u) << MOVE_LEFT;
+    mask |= (up & 1u) << MOVE_UP_LEFT;
+    return mask;
+}
@@ -0,0 +1,452 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/endgame.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include "../include/timing.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Region chica indexada 0..count-1 para el branch-and-bound
+typedef struct {
+    int count;
+    int x[ENDGAME_EXACT_MAX_CELLS];
+    int y[ENDGAME_EXACT_MAX_CELLS];
+    int value[ENDGAME_EXACT_MAX_CELLS];
+    uint64_t adjacency[ENDGAME_EXACT_MAX_CELLS];
+    uint64_t start; // Celdas vecinas de la posicion del jugador
+    int path[ENDGAME_EXACT_MAX_CELLS];
+    int best_path[ENDGAME_EXACT_MAX_CELLS];
+    int best_length;
+    int best_value;
+    uint64_t deadline_ns;
+    unsigned long nodes;
+    bool aborted;
+} exact_t;
+
+int endgame_init(endgame_t* endgame, int width, int height) {
+    size_t cells = (size_t)width * height;
+    memset(endgame, 0, sizeof(*endgame));
+    endgame->width = width;
+    endgame->height = height;
+    endgame->stamp = calloc(cells, sizeof(unsigned int));
+    endgame->queue = malloc(cells * sizeof(int));
+    endgame->plan = malloc(cells);
+    endgame->candidate = malloc(cells);
+    if (!endgame->stamp || !endgame->queue || !endgame->plan || !endgame->candidate) {
+        endgame_free(endgame);
+        return ERR_GENERIC;
+    }
+    return 0;
+}
+
+void endgame_free(endgame_t* endgame) {
+    free(endgame->stamp);
+    free(endgame->queue);
+    free(endgame->plan);
+    free(endgame->candidate);
+    endgame->stamp = NULL;
+    endgame->queue = NULL;
+    endgame->plan = NULL;
+    endgame->candidate = NULL;
+}
+
+static unsigned int next_generation(endgame_t* endgame) {
+    if (++endgame->generation == 0) { // Vuelta del contador: se limpian las marcas una vez
+        memset(endgame->stamp, 0, (size_t)endgame->width * endgame->height * sizeof(unsigned int));
+        endgame->generation = 1;
+    }
+    return endgame->generation;
+}
+
+// Rellena la region libre alcanzable desde el jugador (celdas en queue). Con check_opponents
+// devuelve -1 en cuanto llega a una celda vecina de un rival que todavia puede mover; si no,
+// corta pasadas las `limit` celdas (devuelve limit + 1). *visited queda con las celdas encoladas.
+static int flood_region(endgame_t* e, const board_t* board, const player_t* players, unsigned int player_count, int me, bool check_opponents, int limit, int* visited) {
+    int width = e->width;
+    unsigned int contested = next_generation(e);
+    if (check_opponents) {
+        for (unsigned int p = 0; p < player_count; p++) {
+            if ((int)p == me || players[p].blocked) continue;
+            unsigned char mask = legal_move_mask(board, players[p].x, players[p].y);
+            for (int d = 0; d < NUM_DIRECTIONS; d++) {
+                if (mask & (1u << d)) {
+                    e->stamp[(players[p].y + MOVE_DELTAS[d][1]) * width + players[p].x + MOVE_DELTAS[d][0]] = contested;
+                }
+            }
+        }
+    }
+    unsigned int generation = next_generation(e);
+    int head = 0, tail = 0;
+    int cell = players[me].y * width + players[me].x;
+    e->stamp[cell] = generation;
+    for (;;) {
+        int cx = cell % width, cy = cell / width;
+        unsigned char mask = legal_move_mask(board, cx, cy);
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            if (!(mask & (1u << d))) continue;
+            int next = (cy + MOVE_DELTAS[d][1]) * width + cx + MOVE_DELTAS[d][0];
+            if (e->stamp[next] == generation) continue;
+            if (check_opponents && e->stamp[next] == contested) {
+                *visited = tail;
+                return -1;
+            }
+            if (tail == limit) {
+                *visited = tail;
+                return limit + 1;
+            }
+            e->stamp[next] = generation;
+            e->queue[tail++] = next;
+        }
+        if (head == tail) {
+            *visited = tail;
+            return tail;
+        }
+        cell = e->queue[head++];
+    }
+}
+
+static int direction_between(int fx, int fy, int tx, int ty) {
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (fx + MOVE_DELTAS[d][0] == tx && fy + MOVE_DELTAS[d][1] == ty) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+// Valor del resto del plan sobre el tablero actual
+static int plan_value(const endgame_t* e, const board_t* board) {
+    int x = e->plan_x, y = e->plan_y, total = 0;
+    for (int k = e->plan_next; k < e->plan_length; k++) {
+        x += MOVE_DELTAS[e->plan[k]][0];
+        y += MOVE_DELTAS[e->plan[k]][1];
+        total += board_cell(board, x, y);
+    }
+    return total;
+}
+
+// Salidas libres de (x, y) que el recorrido (marcado con walk) todavia no piso
+static unsigned char walk_exits(const endgame_t* e, const board_t* board, int x, int y, unsigned int walk) {
+    unsigned char mask = legal_move_mask(board, x, y);
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if ((mask & (1u << d)) && e->stamp[(y + MOVE_DELTAS[d][1]) * e->width + x + MOVE_DELTAS[d][0]] == walk) {
+            mask &= (unsigned char)~(1u << d);
+        }
+    }
+    return mask;
+}
+
+// Grupos de salidas libres alrededor de una celda: MOVE_DELTAS recorre el anillo de vecinos en
+// orden, dos vecinos seguidos siempre se tocan y dos ortogonales tambien por encima de la esquina.
+// Con un solo grupo ocupar la celda no puede partir la region.
+static int exit_groups(unsigned char exits) {
+    int parent[NUM_DIRECTIONS];
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        parent[d] = d;
+    }
+    int groups = 0;
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (!(exits & (1u << d))) continue;
+        groups++;
+        int links[2] = { (d + 1) % NUM_DIRECTIONS, d % 2 == 0 ? (d + 2) % NUM_DIRECTIONS : d };
+        for (int k = 0; k < 2; k++) {
+            int other = links[k];
+            if (other == d || !(exits & (1u << other))) continue;
+            int a = d, b = other;
+            while (parent[a] != a) a = parent[a];
+            while (parent[b] != b) b = parent[b];
+            if (a != b) {
+                parent[b] = a;
+                groups--;
+            }
+        }
+    }
+    return groups;
+}
+
+// Zonas en que queda partida la region al ocupar (x, y): solo se puede seguir por una. Cada
+// zona se rellena con una generacion nueva (mayor que walk, asi las marcas del recorrido no se
+// pisan) y a lo sumo ENDGAME_CUT_PROBE_CELLS celdas; una zona mas grande queda abierta y se da
+// por buena. Devuelve la recompensa que se pierde y deja en *keep las salidas por las que conviene
+// seguir (las de las zonas abiertas o, si no hay, las de la zona de mas recompensa).
+static int split_zones(endgame_t* e, const board_t* board, int x, int y, unsigned char exits, unsigned int walk, unsigned char* keep) {
+    *keep = exits;
+    if (e->generation > UINT_MAX - NUM_DIRECTIONS) {
+        return 0; // Sin generaciones libres no se mide (una vez cada 2^32 rellenos)
+    }
+    int width = e->width;
+    unsigned int first = e->generation + 1;
+    unsigned int saved = e->stamp[y * width + x];
+    e->stamp[y * width + x] = walk;
+    unsigned int zone[NUM_DIRECTIONS] = {0};
+    unsigned int open_zones[NUM_DIRECTIONS];
+    int open_count = 0, total = 0, largest = -1;
+    unsigned int largest_zone = 0;
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (!(exits & (1u << d))) continue;
+        int start = (y + MOVE_DELTAS[d][1]) * width + x + MOVE_DELTAS[d][0];
+        if (e->stamp[start] >= first) { // Ya alcanzada desde otra salida
+            zone[d] = e->stamp[start];
+            continue;
+        }
+        unsigned int fill = ++e->generation;
+        int head = 0, tail = 0, value = 0;
+        zone[d] = fill;
+        e->stamp[start] = fill;
+        e->queue[tail++] = start;
+        while (head < tail && tail <= ENDGAME_CUT_PROBE_CELLS) {
+            int cell = e->queue[head++];
+            int cx = cell % width, cy = cell / width;
+            value += board_cell(board, cx, cy);
+            unsigned char mask = legal_move_mask(board, cx, cy);
+            for (int k = 0; k < NUM_DIRECTIONS; k++) {
+                if (!(mask & (1u << k))) continue;
+                int next = (cy + MOVE_DELTAS[k][1]) * width + cx + MOVE_DELTAS[k][0];
+                if (e->stamp[next] == walk || e->stamp[next] == fill) continue;
+                e->stamp[next] = fill;
+                e->queue[tail++] = next;
+            }
+        }
+        if (head < tail) {
+            open_zones[open_count++] = fill;
+            continue;
+        }
+        total += value;
+        if (value > largest) {
+            largest = value;
+            largest_zone = fill;
+        }
+    }
+    e->stamp[y * width + x] = saved;
+
+    *keep = 0;
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (!(exits & (1u << d))) continue;
+        bool kept = open_count == 0 && zone[d] == largest_zone;
+        for (int z = 0; z < open_count && !kept; z++) {
+            kept = zone[d] == open_zones[z];
+        }
+        if (kept) {
+            *keep |= (unsigned char)(1u << d);
+        }
+    }
+    return open_count > 0 ? total : total - largest;
+}
+
+// Recorrido tipo Warnsdorff: entre los vecinos libres se prefiere el que no deja recompensa
+// aislada, despues el de mas recompensa (por value_weight) y menos salidas libres, y los
+// callejones sin salida solo como ultimo paso. Escribe las direcciones en path y devuelve la
+// cantidad; *total queda con lo capturado. Si se pasa del deadline el recorrido queda corto y
+// se sigue calculando cuando el jugador llegue a su final.
+static int heuristic_walk(endgame_t* e, const board_t* board, int x, int y, int value_weight, uint64_t deadline_ns, unsigned char* path, int* total) {
+    unsigned int generation = next_generation(e);
+    int width = e->width, length = 0;
+    *total = 0;
+    e->stamp[y * width + x] = generation;
+    for (;;) {
+        if (length > 0 && length % ENDGAME_WALK_CHECK_STEPS == 0 && monotonic_ns() >= deadline_ns) {
+            return length;
+        }
+        unsigned char mask = walk_exits(e, board, x, y, generation);
+        if (mask & (mask - 1) && exit_groups(mask) > 1) {
+            split_zones(e, board, x, y, mask, generation, &mask); // Parado en un corte: solo la mejor zona
+        }
+        int best = -1, best_score = INT_MIN, best_loss = INT_MAX;
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            if (!(mask & (1u << d))) continue;
+            int nx = x + MOVE_DELTAS[d][0], ny = y + MOVE_DELTAS[d][1];
+            unsigned char onward = walk_exits(e, board, nx, ny, generation);
+            int exits = __builtin_popcount(onward);
+            int value = board_cell(board, nx, ny);
+            int score = exits == 0 ? INT_MIN / 2 + value : value * value_weight - exits * ENDGAME_DEGREE_WEIGHT;
+            int loss = 0;
+            if (exits == 0) {
+                loss = INT_MAX / 2; // Callejon: pierde todo lo que queda
+            } else if (exits > 1 && exit_groups(onward) > 1) {
+                unsigned char keep;
+                loss = split_zones(e, board, nx, ny, onward, generation, &keep);
+            }
+            if (loss < best_loss || (loss == best_loss && score > best_score)) {
+                best_loss = loss;
+                best_score = score;
+                best = d;
+            }
+        }
+        if (best < 0) {
+            return length;
+        }
+        x += MOVE_DELTAS[best][0];
+        y += MOVE_DELTAS[best][1];
+        e->stamp[y * width + x] = generation;
+        *total += board_cell(board, x, y);
+        path[length++] = (unsigned char)best;
+    }
+}
+
+static void heuristic_plan(endgame_t* e, const board_t* board, int x, int y, uint64_t deadline_ns) {
+    static const int value_weights[ENDGAME_HEURISTIC_VARIANTS] = { 0, 4, 16, 64 };
+    int best_total = -1;
+    for (int v = 0; v < ENDGAME_HEURISTIC_VARIANTS; v++) {
+        if (v > 0 && monotonic_ns() >= deadline_ns) {
+            break; // Al menos un recorrido siempre (corto si no alcanza el tiempo)
+        }
+        int total;
+        int length = heuristic_walk(e, board, x, y, value_weights[v], deadline_ns, e->candidate, &total);
+        if (total > best_total) {
+            unsigned char* swap = e->plan;
+            e->plan = e->candidate;
+            e->candidate = swap;
+            e->plan_length = length;
+            best_total = total;
+        }
+    }
+    e->plan_next = 0;
+    e->plan_x = x;
+    e->plan_y = y;
+}
+
+// Suma de las recompensas alcanzables desde `from` sin pasar por visited: cota del resto
+static int reachable_bound(const exact_t* s, uint64_t from, uint64_t visited) {
+    uint64_t reach = from & ~visited, frontier = reach;
+    while (frontier) {
+        uint64_t next = 0;
+        for (uint64_t bits = frontier; bits; bits &= bits - 1) {
+            next |= s->adjacency[__builtin_ctzll(bits)];
+        }
+        frontier = next & ~visited & ~reach;
+        reach |= frontier;
+    }
+    int total = 0;
+    for (uint64_t bits = reach; bits; bits &= bits - 1) {
+        total += s->value[__builtin_ctzll(bits)];
+    }
+    return total;
+}
+
+static void exact_search(exact_t* s, uint64_t candidates, uint64_t visited, int depth, int total) {
+    if (++s->nodes % ENDGAME_CLOCK_CHECK_NODES == 0 && monotonic_ns() >= s->deadline_ns) {
+        s->aborted = true;
+    }
+    if (s->aborted) {
+        return;
+    }
+    if (total > s->best_value) {
+        s->best_value = total;
+        s->best_length = depth;
+        memcpy(s->best_path, s->path, (size_t)depth * sizeof(int));
+    }
+    candidates &= ~visited;
+    if (!candidates || total + reachable_bound(s, candidates, visited) <= s->best_value) {
+        return;
+    }
+    // Primero los de mas recompensa
+    int order[NUM_DIRECTIONS], n = 0;
+    for (uint64_t bits = candidates; bits; bits &= bits - 1) {
+        int c = __builtin_ctzll(bits), i = n++;
+        while (i > 0 && s->value[order[i - 1]] < s->value[c]) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = c;
+    }
+    for (int i = 0; i < n && !s->aborted; i++) {
+        int c = order[i];
+        s->path[depth] = c;
+        exact_search(s, s->adjacency[c], visited | ((uint64_t)1 << c), depth + 1, total + s->value[c]);
+    }
+}
+
+// Branch-and-bound sobre las `count` celdas de queue; reemplaza el plan si encuentra uno mejor
+static void exact_plan(endgame_t* e, const board_t* board, int x, int y, int count, uint64_t deadline_ns) {
+    exact_t s;
+    s.count = count;
+    s.start = 0;
+    for (int i = 0; i < count; i++) {
+        s.x[i] = e->queue[i] % e->width;
+        s.y[i] = e->queue[i] / e->width;
+        s.value[i] = board_cell(board, s.x[i], s.y[i]);
+        s.adjacency[i] = 0;
+    }
+    for (int i = 0; i < count; i++) {
+        if (abs(s.x[i] - x) <= 1 && abs(s.y[i] - y) <= 1) {
+            s.start |= (uint64_t)1 << i;
+        }
+        for (int j = i + 1; j < count; j++) {
+            if (abs(s.x[i] - s.x[j]) <= 1 && abs(s.y[i] - s.y[j]) <= 1) {
+                s.adjacency[i] |= (uint64_t)1 << j;
+                s.adjacency[j] |= (uint64_t)1 << i;
+            }
+        }
+    }
+    bool on_plan = e->plan_x == x && e->plan_y == y;
+    s.best_value = on_plan ? plan_value(e, board) : -1;
+    s.best_length = -1; // Sin mejora se conserva el plan actual
+    s.deadline_ns = deadline_ns;
+    s.nodes = 0;
+    s.aborted = false;
+    exact_search(&s, s.start, 0, 0, 0);
+
+    if (s.best_length >= 0) {
+        int px = x, py = y;
+        for (int k = 0; k < s.best_length; k++) {
+            int c = s.best_path[k];
+            e->plan[k] = (unsigned char)direction_between(px, py, s.x[c], s.y[c]);
+            px = s.x[c];
+            py = s.y[c];
+        }
+        e->plan_length = s.best_length;
+        e->plan_next = 0;
+        e->plan_x = x;
+        e->plan_y = y;
+    }
+    e->exact = !s.aborted;
+}
+
+bool endgame_move(endgame_t* endgame, const board_t* board, const player_t* players, unsigned int player_count, int me, uint64_t deadline_ns, signed char* move) {
+    int x = players[me].x, y = players[me].y;
+    int visited = 0;
+    if (!endgame->sealed) {
+        if (endgame->seal_wait > 0) {
+            endgame->seal_wait--;
+            return false;
+        }
+        // Con los rivales lejos el relleno es largo: se lo corta y se espera en proporcion antes de
+        // repetirlo, asi el costo por turno del motor elegido casi no cambia
+        int count = flood_region(endgame, board, players, player_count, me, true, ENDGAME_SEAL_MAX_CELLS, &visited);
+        if (count < 0 || count > ENDGAME_SEAL_MAX_CELLS) {
+            endgame->seal_wait = visited / ENDGAME_SEAL_CELLS_PER_TURN;
+            return false;
+        }
+        endgame->sealed = true;
+        endgame->plan_length = 0;
+        endgame->plan_next = 0;
+    }
+
+    bool on_plan = endgame->plan_x == x && endgame->plan_y == y && endgame->plan_next < endgame->plan_length;
+    if (on_plan) {
+        int d = endgame->plan[endgame->plan_next];
+        on_plan = board_cell(board, x + MOVE_DELTAS[d][0], y + MOVE_DELTAS[d][1]) > 0;
+    }
+    if (!on_plan) {
+        heuristic_plan(endgame, board, x, y, deadline_ns);
+        endgame->exact = false;
+    }
+    if (!endgame->exact) {
+        // Se reintenta mientras no este probado: la region se achica con cada movimiento
+        int count = flood_region(endgame, board, players, player_count, me, false, ENDGAME_EXACT_MAX_CELLS, &visited);
+        if (count <= ENDGAME_EXACT_MAX_CELLS) {
+            exact_plan(endgame, board, x, y, count, deadline_ns);
+        }
+    }
+
+    if (endgame->plan_next >= endgame->plan_length) {
+        *move = -1;
+        return true;
+    }
+    int d = endgame->plan[endgame->plan_next++];
+    endgame->plan_x = x + MOVE_DELTAS[d][0];
+    endgame->plan_y = y + MOVE_DELTAS[d][1];
+    *move = (signed char)d;
+    return true;
+}
@@ -1,6 +1,7 @@
 #define _POSIX_C_SOURCE 200809L
 #include "../include/game_functions.h"
 #include "../include/structs.h"
+#include "../include/bitboard.h"
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -23,10 +24,43 @@ const int MOVE_DELTAS[NUM_DIRECTIONS][2] = {
 };
 
 
+size_t board_bytes(int height, int stride, unsigned char cell_bytes) {
+    return (size_t)(height + 2 * BOARD_BORDER) * stride * cell_bytes;
+}
+
+static inline size_t cell_index(const board_t* board, int x, int y) {
+    return (size_t)(y + BOARD_BORDER) * board->stride + (size_t)(x + BOARD_BORDER);
+}
+
+int board_cell(const board_t* board, int x, int y) {
+    if (board->cell_bytes == COMPACT_CELL_BYTES) {
+        return ((const int8_t*)board->cells)[cell_index(board, x, y)];
+    }
+    return ((const int*)board->cells)[cell_index(board, x, y)];
+}
+
+void board_set_cell(board_t* board, int x, int y, int value) {
+    if (board->cell_bytes == COMPACT_CELL_BYTES) {
+        ((int8_t*)board->cells)[cell_index(board, x, y)] = (int8_t)value;
+    } else {
+        ((int*)board->cells)[cell_index(board, x, y)] = value;
+    }
+    free_plane_update(board, x, y, value);
+}
+
 void initialize_board(game_state_t* state, unsigned int seed) {
+    board_t board = game_board(state);
     srand(seed);
-    for (int i = 0; i < state->width * state->height; i++) {
-        state->board[i] = (rand() % MAX_CELL_VALUE) + MIN_CELL_VALUE;
+    // El borde, el relleno y el plano de libres se ponen en 0 a mano: create_shared_memory no trunca,
+    // asi que el segmento de una partida que termino mal conserva sus bytes
+    memset(board.cells, 0, board_bytes(state->height, board.stride, board.cell_bytes));
+    if (board.free_bits) {
+        memset(board.free_bits - FREE_PLANE_GUARD_WORDS, 0, free_plane_bytes(state->width, state->height));
+    }
+    for (int y = 0; y < state->height; y++) {
+        for (int x = 0; x < state->width; x++) {
+            board_set_cell(&board, x, y, (rand() % MAX_CELL_VALUE) + MIN_CELL_VALUE);
+        }
     }
 }
 
@@ -34,40 +68,27 @@ bool is_valid_position(int x, int y, int width, int height) {
     return x >= 0 && x < width && y >= 0 && y < height;
 }
 
-bool is_cell_free(int* board, int x, int y, int width, int height) {
-    if(!is_valid_position(x, y, width, height)){
-        return false;
-    }
-    int cell_value = board[y * width + x];
-    return cell_value > 0; // Valores positivos = celdas libres
+bool is_cell_free(const board_t* board, int x, int y) {
+    return board_cell(board, x, y) > 0; // Valores positivos = celdas libres; el borde vale 0
 }
 
-int get_cell_value(int* board, int x, int y, int width, int height) {
-    if (!is_valid_position(x, y, width, height)) {
-        return -1;
-    }
-    return board[y * width + x];
+int get_cell_value(const board_t* board, int x, int y) {
+    return board_cell(board, x, y);
 }
 
-bool is_player_blocked(int* board, int x, int y, int width, int height) {
-    for (int move = 0; move < 8; move++) {
-        int new_x = x + MOVE_DELTAS[move][0];
-        int new_y = y + MOVE_DELTAS[move][1];
-        if (is_cell_free(board, new_x, new_y, width, height)) {
-            return false; // Al menos un movimiento es posible
-        }
-    }
-    return true; // No hay movimientos posibles
+bool is_player_blocked(const board_t* board, int x, int y) {
+    return legal_move_mask(board, x, y) == 0; // Ningun vecino libre en el plano de libres
 }
 
-void set_cell_owner(game_state_t* state, int x, int y, int player_id) {
-    if (is_valid_position(x, y, state->width, state->height)) {
-        state->board[y * state->width + x] = -(player_id + PLAYER_ID_OFFSET);
+void set_cell_owner(board_t* board, int x, int y, int player_id) {
+    if (is_valid_position(x, y, board->width, board->height)) {
+        board_set_cell(board, x, y, -(player_id + PLAYER_ID_OFFSET));
     }
 }
 
 void place_players_on_board(game_state_t* state){
-    int positions[][2] = {
+    board_t board = game_board(state);
+    int positions[PRESET_POSITIONS][2] = {
         {PLAYER_POSITION_MARGIN, PLAYER_POSITION_MARGIN},                                    // Jugador 0
         {state->width - PLAYER_POSITION_OFFSET, PLAYER_POSITION_MARGIN},                     // Jugador 1
         {PLAYER_POSITION_MARGIN, state->height - PLAYER_POSITION_OFFSET},                    // Jugador 2
@@ -78,13 +99,34 @@ void place_players_on_board(game_state_t* state){
         {state->width / 2, state->height - PLAYER_POSITION_OFFSET},     // Jugador 7
         {state->width / 2, state->height / 2}      // Jugador 8
     };
+
+    // Con mas jugadores que posiciones predefinidas se los reparte en una grilla uniforme
+    int cols = 1;
+    while (cols * cols < (int)state->player_count) cols++;
+    int rows = ((int)state->player_count + cols - 1) / cols;
     
     for (unsigned int i = 0; i < state->player_count; i++) {
-        state->players[i].x = positions[i][0];
-        state->players[i].y = positions[i][1];
+        int x, y;
+        if (state->player_count <= PRESET_POSITIONS) {
+            x = positions[i][0];
+            y = positions[i][1];
+        } else {
+            x = (2 * ((int)i % cols) + 1) * state->width / (2 * cols);
+            y = (2 * ((int)i / cols) + 1) * state->height / (2 * rows);
+            // Si la celda ya esta tomada se avanza a la siguiente libre (recorrido por filas)
+            int cell = y * state->width + x;
+            int cells = state->width * state->height;
+            while (board_cell(&board, cell % state->width, cell / state->width) <= 0) {
+                cell = (cell + 1) % cells;
+            }
+            x = cell % state->width;
+            y = cell / state->width;
+        }
+        state->players[i].x = x;
+        state->players[i].y = y;
         
         // Marcar la celda inicial como ocupada (sin recompensa)
-        set_cell_owner(state, positions[i][0], positions[i][1], (int)i);
+        set_cell_owner(&board, x, y, (int)i);
     }
 }
 
@@ -95,18 +137,34 @@ void apply_move(game_state_t* game_state,int  player_id, unsigned char move) {//
     int new_x = current_x + MOVE_DELTAS[move][0];
     int new_y = current_y + MOVE_DELTAS[move][1];
 
-    int reward = get_cell_value(game_state->board, new_x, new_y, game_state->width, game_state->height);
+    board_t board = game_board(game_state);
+    int reward = get_cell_value(&board, new_x, new_y);
 
     game_state->players[player_id].x = new_x;
     game_state->players[player_id].y = new_y;
 
     game_state->players[player_id].score += reward;
 
-    set_cell_owner(game_state, new_x, new_y, player_id);
+    set_cell_owner(&board, new_x, new_y, player_id);
     game_state->players[player_id].valid_moves++;
+    record_delta(game_state, player_id, new_x, new_y);
+}
+
+void record_delta(game_state_t* state, int player_id, int x, int y) {
+    if (state->delta_capacity == 0) {
+        return;
+    }
+    board_delta_t* delta = &game_deltas(state)[state->delta_version % state->delta_capacity];
+    delta->cell = (unsigned int)(y * state->width + x);
+    board_t board = game_board(state);
+    delta->owner = board_cell(&board, x, y);
+    delta->player = (unsigned short)player_id;
+    delta->x = (unsigned short)x;
+    delta->y = (unsigned short)y;
+    state->delta_version++;
 }
 
-int is_valid_move(int* board, unsigned char move, int x, int y, bool blocked, int width, int height) {
+int is_valid_move(const board_t* board, unsigned char move, int x, int y, bool blocked) {
     if (move > MOVE_UP_LEFT) {
         return false;
     }
@@ -119,7 +177,7 @@ int is_valid_move(int* board, unsigned char move, int x, int y, bool blocked, in
     int new_x = current_x + MOVE_DELTAS[move][0];
     int new_y = current_y + MOVE_DELTAS[move][1];
     
-    return is_cell_free(board, new_x, new_y, width, height);
+    return is_cell_free(board, new_x, new_y);
  }
 
  int determine_winner(game_state_t* state) {
@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/game_stats.h"
+#include "../include/timing.h"
+#include <string.h>
+#include <unistd.h>
+
+static const char* const STAGE_NAMES[STATS_STAGE_COUNT] = { "think", "lock_wait", "critical", "view" };
+
+size_t game_stats_size(int player_count) {
+    return sizeof(game_stats_t) + (size_t)player_count * sizeof(stats_player_t);
+}
+
+void game_stats_init(game_stats_t* stats, int player_count) {
+    memset(stats, 0, game_stats_size(player_count));
+    stats->version = GAME_STATS_VERSION;
+    stats->player_count = (uint32_t)player_count;
+    stats->stage_count = STATS_STAGE_COUNT;
+    stats->bucket_count = STATS_BUCKETS;
+    stats->master_pid = getpid();
+    stats->started_ns = monotonic_ns();
+    __atomic_store_n(&stats->magic, GAME_STATS_MAGIC, __ATOMIC_RELEASE); // Recien ahora es legible
+}
+
+int stats_bucket_index(uint64_t value_ns) {
+    if (value_ns < STATS_SUB_BUCKETS) {
+        return (int)value_ns;
+    }
+    int exponent = 63 - __builtin_clzll(value_ns);
+    if (exponent > STATS_MAX_EXPONENT) {
+        return STATS_BUCKETS - 1;
+    }
+    int shift = exponent - STATS_SUB_BUCKET_BITS;
+    return STATS_SUB_BUCKETS * (shift + 1) + (int)((value_ns >> shift) & (STATS_SUB_BUCKETS - 1));
+}
+
+uint64_t stats_bucket_upper_ns(int index) {
+    if (index < STATS_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int shift = index / STATS_SUB_BUCKETS - 1;
+    uint64_t lower = (uint64_t)(STATS_SUB_BUCKETS + index % STATS_SUB_BUCKETS) << shift;
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+// Unico escritor: alcanza con load + store atomicos (sin RMW) para que ningun lector vea un
+// contador a medio escribir
+static inline void add_relaxed(uint64_t* counter, uint64_t value) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+void game_stats_record(game_stats_t* stats, int player, int stage, uint64_t value_ns) {
+    stats_histogram_t* histogram = &stats->players[player].stages[stage];
+    add_relaxed(&histogram->buckets[stats_bucket_index(value_ns)], 1);
+    add_relaxed(&histogram->sum_ns, value_ns);
+    if (value_ns > histogram->max_ns) {
+        __atomic_store_n(&histogram->max_ns, value_ns, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&histogram->count, histogram->count + 1, __ATOMIC_RELEASE);
+}
+
+const char* game_stats_stage_name(int stage) {
+    return stage >= 0 && stage < STATS_STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+uint64_t stats_percentile_ns(const stats_histogram_t* histogram, unsigned int percentile) {
+    uint64_t total = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        total += histogram->buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // Mismo criterio que percentile_ns: la muestra (total - 1) * p / 100 en orden
+    uint64_t rank = (total - 1) * percentile / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen > rank) {
+            uint64_t upper = stats_bucket_upper_ns(i);
+            return upper < histogram->max_ns || histogram->max_ns == 0 ? upper : histogram->max_ns;
+        }
+    }
+    return histogram->max_ns;
+}
@@ -0,0 +1,46 @@
+#include "../include/greedy.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include <limits.h>
+#include <stdlib.h>
+
+int evaluate_cell(const board_t* board, int x, int y, int free_neighbors) {
+    // (x, y) es vecina de una posicion valida: a lo sumo cae en el borde, que se lee como ocupado
+    if (!is_cell_free(board, x, y)) {
+        return OCCUPIED_CELL_SCORE; // Celda ocupada o fuera del tablero
+    }
+    
+    int reward = get_cell_value(board, x, y);
+    int score = reward * BASE_REWARD_MULTIPLIER; // Valor base de la recompensa
+    
+    // Bonificar celdas que nos acercan al centro (más opciones futuras)
+    int center_x = board->width / 2;
+    int center_y = board->height / 2;
+    int distance_to_center = abs(x - center_x) + abs(y - center_y);
+    score += (CENTER_BONUS_MAX - distance_to_center); // Bonificar cercanía al centro
+    
+    // Celdas libres adyacentes (movilidad futura), contadas en el plano de libres
+    return score + free_neighbors * MOBILITY_BONUS;
+}
+
+signed char calculate_move(const board_t* board, int x, int y, bool blocked, territory_t* territory) {
+    int best = -1, best_score = INT_MIN;
+    unsigned char legal = blocked ? 0 : legal_move_mask(board, x, y);
+    if (!legal) {
+        return -1;
+    }
+
+    for (unsigned char d = 0; d < NUM_DIRECTIONS; d++) {
+        if (legal & (1u << d)) {
+            int nx = x + MOVE_DELTAS[(int)d][0];
+            int ny = y + MOVE_DELTAS[(int)d][1];
+            // Movilidad del candidato: solo la ventana 3x3 que lo rodea en el plano de libres
+            int s = evaluate_cell(board, nx, ny, __builtin_popcount(legal_move_mask(board, nx, ny)));
+            if (territory) {
+                s += territory_measure(territory, board, nx, ny).value * TERRITORY_VALUE_WEIGHT;
+            }
+            if (s > best_score) { best_score = s; best = d; }
+        }
+    }
+    return (signed char)best;  // -1 si no encontro
+}
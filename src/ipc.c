@@ -1,6 +1,8 @@
 #define _POSIX_C_SOURCE 200809L
 #include "../include/ipc.h"
 #include "../include/structs.h"
+#include "../include/bitboard.h"
+#include "../include/game_functions.h"
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -9,8 +11,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <semaphore.h>
+#include <sched.h>
 
-int create_shared_memory(const char* name, size_t size) {
+const char* shm_name(const char* base, char* buffer, size_t size) {
+    const char* game_id = getenv(GAME_ID_ENV);
+    if (!game_id || game_id[0] == '\0') {
+        snprintf(buffer, size, "%s", base);
+    } else {
+        snprintf(buffer, size, "%s_%s", base, game_id);
+    }
+    return buffer;
+}
+
+bool is_valid_game_id(const char* game_id) {
+    size_t length = strlen(game_id);
+    if (length == 0 || length > GAME_ID_MAX_LENGTH) return false;
+    for (size_t i = 0; i < length; i++) {
+        char c = game_id[i];
+        bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!allowed) return false;
+    }
+    return true;
+}
+
+int create_shared_memory(const char* base_name, size_t size) {
+    char name[SHM_NAME_MAX_LENGTH];
+    shm_name(base_name, name, sizeof(name));
     int shm_fd = shm_open(name, O_CREAT | O_RDWR, SHM_PERMISSIONS);
     if (shm_fd == -1){
         perror("Error al crear memoria compartida");
@@ -24,7 +50,9 @@ int create_shared_memory(const char* name, size_t size) {
     return shm_fd;
 }
 
-int connect_to_shared_memory(const char* name, bool read_only) {
+int connect_to_shared_memory(const char* base_name, bool read_only) {
+    char name[SHM_NAME_MAX_LENGTH];
+    shm_name(base_name, name, sizeof(name));
     int flags = read_only ? O_RDONLY : O_RDWR;
     int shm_fd = shm_open(name, flags, SHM_CONNECT_PERMISSIONS);
     if (shm_fd == -1) {
@@ -50,45 +78,117 @@ void detach_shared_memory(void* addr, size_t size) {
     }
 }
 
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t game_state_board_offset(int player_count) {
+    return align_up(sizeof(game_state_t) + player_count * sizeof(player_t), SHM_ALIGNMENT);
+}
+
+size_t game_state_free_offset(int width, int height, int player_count, unsigned char cell_bytes) {
+    return align_up(game_state_board_offset(player_count) + board_bytes(height, board_row_stride(width, cell_bytes), cell_bytes), SHM_ALIGNMENT);
+}
+
+size_t game_state_delta_offset(int width, int height, int player_count, unsigned char cell_bytes) {
+    return align_up(game_state_free_offset(width, height, player_count, cell_bytes) + free_plane_bytes(width, height), SHM_ALIGNMENT);
+}
+
+size_t game_state_size(int width, int height, int player_count, unsigned char cell_bytes) {
+    return game_state_delta_offset(width, height, player_count, cell_bytes) + DELTA_LOG_CAPACITY * sizeof(board_delta_t);
+}
+
+size_t game_sync_size(int player_count) {
+    return sizeof(game_sync_t) + player_count * sizeof(sem_t);
+}
+
 void cleanup_shared_memory(game_state_t* gamestate, game_sync_t* gamesync) {
     if(gamestate){
-        size_t state_size = sizeof(game_state_t) + (gamestate->width * gamestate->height * sizeof(int));
-        detach_shared_memory(gamestate, state_size);
+        detach_shared_memory(gamestate, gamestate->total_size);
     }
     if(gamesync){
-        detach_shared_memory(gamesync, sizeof(game_sync_t));
+        detach_shared_memory(gamesync, game_sync_size(gamesync->player_count));
     }
 }
 
-void clear_shm(const char* name){
+void clear_shm(const char* base_name){
+    char name[SHM_NAME_MAX_LENGTH];
+    shm_name(base_name, name, sizeof(name));
     if (shm_unlink(name) == -1) {
         perror("shm_unlink");
     }
 }
 
 
+void initialize_game_state(game_state_t* state, int width, int height, int player_count, unsigned char cell_bytes, unsigned int seed) {
+    state->layout_version = GAME_STATE_LAYOUT_VERSION;
+    state->cell_bytes = cell_bytes;
+    state->board_offset = game_state_board_offset(player_count);
+    state->board_stride = (unsigned int)board_row_stride(width, cell_bytes);
+    state->free_offset = game_state_free_offset(width, height, player_count, cell_bytes);
+    state->delta_offset = game_state_delta_offset(width, height, player_count, cell_bytes);
+    state->delta_capacity = DELTA_LOG_CAPACITY;
+    state->delta_version = 0;
+    state->frame = 0;
+    state->total_size = game_state_size(width, height, player_count, cell_bytes);
+    state->width = (unsigned short)width;
+    state->height = (unsigned short)height;
+    state->player_count = (unsigned int)player_count;
+    state->is_game_over = false;
+    state->state_seq = 0;
+
+    for (int i = 0; i < player_count; i++) {
+        snprintf(state->players[i].name, MAX_NAME_LENGTH, "Player%hu", (unsigned short)i);
+        state->players[i].score = 0;
+        state->players[i].invalid_moves = 0;
+        state->players[i].valid_moves = 0;
+        state->players[i].blocked = false;
+        state->players[i].pid = 0;
+    }
+    initialize_board(state, seed);
+    place_players_on_board(state);
+}
+
 game_state_t* setup_game_state(int width, int height){
     int fd = connect_to_shared_memory(GAME_STATE_SHM, true);
-    size_t state_size = sizeof(game_state_t) + (width * height * sizeof(int));
-    game_state_t* game_state = (game_state_t*)attach_shared_memory(fd, state_size, true);
-    if(!game_state){
+    if (fd < 0) {
+        return NULL;
+    }
+    // Primero se mapea solo el encabezado para conocer el tamaño real del segmento
+    game_state_t* header = (game_state_t*)attach_shared_memory(fd, sizeof(game_state_t), true);
+    if(!header){
         close(fd);
         return NULL;
     }
+    if (header->layout_version != GAME_STATE_LAYOUT_VERSION || header->width != width || header->height != height) {
+        fprintf(stderr, "Layout de memoria compartida incompatible (version %u, %ux%u)\n", header->layout_version, header->width, header->height);
+        detach_shared_memory(header, sizeof(game_state_t));
+        close(fd);
+        return NULL;
+    }
+    size_t state_size = header->total_size;
+    detach_shared_memory(header, sizeof(game_state_t));
+
+    game_state_t* game_state = (game_state_t*)attach_shared_memory(fd, state_size, true);
     close(fd);
     return game_state;
 }
 
 game_sync_t* setup_game_sync(){
     int fd = connect_to_shared_memory(GAME_SYNC_SHM, false);
-    if (fd == -1) {
+    if (fd < 0) {
         return NULL;
     }
-    game_sync_t* game_sync = (game_sync_t*)attach_shared_memory(fd, sizeof(game_sync_t), false);
-    close(fd);
-    if (!game_sync) {
+    game_sync_t* header = (game_sync_t*)attach_shared_memory(fd, sizeof(game_sync_t), false);
+    if (!header) {
+        close(fd);
         return NULL;
     }
+    size_t sync_size = game_sync_size(header->player_count);
+    detach_shared_memory(header, sizeof(game_sync_t));
+
+    game_sync_t* game_sync = (game_sync_t*)attach_shared_memory(fd, sync_size, false);
+    close(fd);
     return game_sync;        
 }
 
@@ -99,6 +199,7 @@ void initialize_semaphores(game_sync_t* sync, int player_count){
     sem_init(&sync->state_mutex, SEM_SHARED_PROCESS, SEM_INITIAL_VALUE_MUTEX);
     sem_init(&sync->reader_count_mutex, SEM_SHARED_PROCESS, SEM_INITIAL_VALUE_MUTEX);
     sync->readers_count = 0;
+    sync->player_count = player_count;
     
     for (int i = 0; i < player_count; i++) {
         sem_init(&sync->player_turn[i], SEM_SHARED_PROCESS, SEM_INITIAL_VALUE_MUTEX);
@@ -117,6 +218,82 @@ void cleanup_semaphores(game_sync_t* sync, int player_count) {
     }
 }
 
+void reader_enter(game_sync_t* sync) {
+    sem_wait(&sync->writer_mutex);      // Prevenir inanición del máster
+    sem_wait(&sync->reader_count_mutex);
+    
+    sync->readers_count++;
+    if (sync->readers_count == 1) {     // Primer lector bloquea al máster
+        sem_wait(&sync->state_mutex);
+    }
+    
+    sem_post(&sync->reader_count_mutex);
+    sem_post(&sync->writer_mutex);
+}
+
+void reader_exit(game_sync_t* sync) {
+    sem_wait(&sync->reader_count_mutex);
+    
+    sync->readers_count--;
+    if (sync->readers_count == 0) {     // Ultimo lector libera al máster
+        sem_post(&sync->state_mutex);
+    }
+    
+    sem_post(&sync->reader_count_mutex);
+}
+
+void writer_enter(game_sync_t* sync) {
+    sem_wait(&sync->writer_mutex);
+    sem_wait(&sync->state_mutex);
+}
+
+void writer_exit(game_sync_t* sync) {
+    sem_post(&sync->state_mutex);
+    sem_post(&sync->writer_mutex);
+}
+
+void state_write_begin(game_state_t* state) {
+    unsigned int seq = __atomic_load_n(&state->state_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->state_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE); // el contador impar se publica antes que los datos
+}
+
+void state_write_end(game_state_t* state) {
+    unsigned int seq = __atomic_load_n(&state->state_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->state_seq, seq + 1, __ATOMIC_RELEASE);
+    // Un cuadro nuevo para los espectadores (solo escribe quien tiene el seqlock)
+    unsigned long long frame = __atomic_load_n(&state->frame, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->frame, frame + 1, __ATOMIC_RELEASE);
+}
+
+unsigned int state_read_begin(const game_state_t* state) {
+    unsigned int spins = 0;
+    for (;;) {
+        unsigned int seq = __atomic_load_n(&state->state_seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) == 0) {
+            return seq;
+        }
+        // El máster esta escribiendo: se reintenta sin bloquearlo, cediendo el core si tarda
+        if (++spins == SEQLOCK_SPIN_LIMIT) {
+            spins = 0;
+            sched_yield();
+        }
+    }
+}
+
+bool state_read_retry(const game_state_t* state, unsigned int start) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // las lecturas de datos terminan antes de releer el contador
+    return __atomic_load_n(&state->state_seq, __ATOMIC_RELAXED) != start;
+}
+
+void read_state_snapshot(const game_state_t* shared, game_state_t* local) {
+    unsigned int seq;
+    do {
+        seq = state_read_begin(shared);
+        memcpy(local, shared, shared->total_size);
+    } while (state_read_retry(shared, seq));
+}
+
 int is_executable_file(const char *path) {
     if (!path) return 0;
     if (access(path, F_OK | X_OK) != 0) return 0; // existe y es ejecutable
@@ -6,11 +6,16 @@
 #include <time.h>
 #include "../include/game_functions.h"
 #include "../include/ipc.h"
+#include "../include/timing.h"
+#include "../include/replay_log.h"
+#include "../include/game_stats.h"
+#include "../include/move_channel.h"
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
+#include <poll.h>
 #include <sys/time.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -22,6 +27,10 @@
 #define DEFAULT_HEIGHT MIN_BOARD_SIZE
 #define DEFAULT_DELAY 200 //MILISEGUNDOS
 #define DEFAULT_TIMEOUT 10
+#define INITIAL_LATENCY_SAMPLES 4096
+#define REAP_POLL_MS 2
+#define MOVE_BUDGET_MAX_MISSES 3 // Presupuestos vencidos seguidos tras los que el jugador queda bloqueado
+#define MOVE_BUDGET_STARTUP_MS 1000 // Margen del primer turno (arranque del proceso del jugador)
 
 typedef struct {
     int width;
@@ -30,35 +39,114 @@ typedef struct {
     int timeout;
     unsigned int seed;
     char* view_path;
+    char* record_path; // Archivo de replay (-r) o NULL
     char* player_paths[MAX_PLAYERS];
     int player_count;
+    bool turbo; // Sin vista ni demoras; reporta el rendimiento al terminar
+    bool summary; // Imprime el resultado de cada jugador en formato CSV
+    bool sync_rwsem; // Ademas del seqlock, toma writer_mutex/state_mutex para lectores con semaforos
+    bool compact; // Tablero de una celda por byte (int8_t)
+    bool spectate; // La vista dibuja a su ritmo (fps) y el máster nunca la espera
+    int fps; // Cuadros por segundo de la vista en modo espectador
+    unsigned long max_moves; // La partida termina tras esta cantidad de movimientos procesados (0: sin limite)
+    long budget_ms; // Tiempo de cada jugador para contestar su turno (0: sin limite)
+    bool transport_shm; // Turnos y movimientos por anillos en /game_moves en vez de semaforos y pipes
 } master_config_t;
 
+typedef struct {
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t* latencies_ns; // Ida y vuelta: sem_post(player_turn) hasta leer el movimiento
+    size_t count;
+    size_t capacity;
+} turbo_stats_t;
+
 typedef struct {
     pid_t pid;
-    int pipe_fd;
+    int pipe_fd; // -1 con --transport shm
     bool active;
+    bool watched; // El pipe esta registrado en epoll (o su anillo se revisa) y el jugador sigue en juego
+    bool reaped; // Ya se recolecto su estado de salida
+    int status;
+    uint64_t deadline_ns; // Vence el presupuesto del turno pendiente (con --budget)
+    bool late; // El turno ya se cobro como invalido: lo que mande se descarta
+    int misses; // Presupuestos vencidos seguidos
 } player_process_t;
 
 static game_state_t* game_state = NULL;
 static game_sync_t* game_sync = NULL;
+static game_stats_t* game_stats = NULL; // Histogramas por etapa (/game_stats) o NULL si no se pudo crear
 static player_process_t players[MAX_PLAYERS] = {0}; //evita hacerle kill a los jugadores inexistentes por ejemplo
 static pid_t view_pid = -1;
+static bool view_reaped = false;
+static int view_status = 0;
 static int state_shm_fd = -1;
 static int sync_shm_fd = -1;
+static int stats_shm_fd = -1;
+static size_t stats_size = 0;
+static move_channels_t* move_channels = NULL; // Con --transport shm
+static int moves_shm_fd = -1;
+static size_t moves_size = 0;
+static int epoll_fd = -1;
+static int playing_count = 0; // Jugadores activos y no bloqueados
+static uint64_t turn_posted_ns[MAX_PLAYERS]; // Ultimo sem_post(player_turn) de cada jugador
+static turbo_stats_t turbo_stats = {0};
+static replay_log_t replay_log = {0};
 static volatile sig_atomic_t interrupted = 0; //para saber si hubo una señal de interrupcion
 
-static inline bool all_players_blocked_or_inactive(const master_config_t* cfg) {
-    for (int i = 0; i < cfg->player_count; i++) {
-        if (players[i].active && !game_state->players[i].blocked) {
-            return false;
+static inline void record_stage(int id, int stage, uint64_t value_ns) {
+    if (game_stats) game_stats_record(game_stats, id, stage, value_ns);
+}
+
+static inline bool all_players_blocked_or_inactive(void) {
+    return playing_count == 0;
+}
+
+// Deja de escuchar el pipe del jugador. Si close_pipe es false el pipe queda abierto
+// para que un jugador bloqueado que todavia escribe no reciba SIGPIPE.
+static void retire_player(int id, bool close_pipe) {
+    if (players[id].watched) {
+        if (players[id].pipe_fd != -1) epoll_ctl(epoll_fd, EPOLL_CTL_DEL, players[id].pipe_fd, NULL);
+        players[id].watched = false;
+        playing_count--;
+    }
+    if (close_pipe) {
+        if (players[id].pipe_fd != -1) {
+            close(players[id].pipe_fd);
+            players[id].pipe_fd = -1;
         }
+        players[id].active = false;
     }
-    return true;
 }
 
-static void notify_view_and_wait_ms(long ms) {
-    if (view_pid <= 0) return;
+static int watch_players(const master_config_t* config) {
+    if (!move_channels) {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd == -1) {
+            perror("Error al crear epoll");
+            return ERR_GENERIC;
+        }
+    }
+    for (int i = 0; i < config->player_count; i++) {
+        if (!players[i].active) continue;
+        if (move_channels) { // Los anillos se revisan en cada vuelta: no hay nada que registrar
+            players[i].watched = true;
+            playing_count++;
+            continue;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = (uint32_t)i };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, players[i].pipe_fd, &ev) == -1) {
+            perror("Error al registrar pipe en epoll");
+            return ERR_GENERIC;
+        }
+        players[i].watched = true;
+        playing_count++;
+    }
+    return 0;
+}
+
+static void notify_view_and_wait_ms(const master_config_t* config, long ms) {
+    if (view_pid <= 0 || config->spectate) return; // El espectador no recibe avisos: lee el contador de cuadros
     sem_post(&game_sync->view_notify);
 
     //timed wait para evitar deadlocks si view muere
@@ -74,6 +162,20 @@ static void notify_view_and_wait_ms(long ms) {
     }
 }
 
+// El espectador ve el fin de la partida por su cuenta y termina solo
+static void wait_view_exit_ms(long ms) {
+    if (view_pid <= 0) return;
+    struct timespec poll_ts = { .tv_sec = 0, .tv_nsec = REAP_POLL_MS * MS_TO_NS };
+    uint64_t deadline_ns = monotonic_ns() + (uint64_t)ms * MS_TO_NS;
+    while (!view_reaped && !interrupted && monotonic_ns() < deadline_ns) {
+        if (waitpid(view_pid, &view_status, WNOHANG) == view_pid) {
+            view_reaped = true;
+        } else {
+            nanosleep(&poll_ts, NULL);
+        }
+    }
+}
+
 void clear_resources(){
     int count = game_state ? game_state->player_count : 0;
     if (game_sync) cleanup_semaphores(game_sync, count); //sem_destroy
@@ -87,6 +189,22 @@ void clear_resources(){
         close(sync_shm_fd);
         clear_shm(GAME_SYNC_SHM); //unlink
     }
+    if (game_stats) {
+        detach_shared_memory(game_stats, stats_size);
+        game_stats = NULL;
+    }
+    if (stats_shm_fd != -1) {
+        close(stats_shm_fd);
+        clear_shm(GAME_STATS_SHM);
+    }
+    if (move_channels) {
+        detach_shared_memory(move_channels, moves_size);
+        move_channels = NULL;
+    }
+    if (moves_shm_fd != -1) {
+        close(moves_shm_fd);
+        clear_shm(GAME_MOVES_SHM);
+    }
 
     for (int i = 0; i < count; i++) {
         if (players[i].pipe_fd != -1){
@@ -94,6 +212,10 @@ void clear_resources(){
             players[i].pipe_fd = -1;
         }
     }
+    if (epoll_fd != -1) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
 }
 
 void parser(master_config_t* config, int argc, char *argv[]){
@@ -104,7 +226,17 @@ void parser(master_config_t* config, int argc, char *argv[]){
     config->timeout = DEFAULT_TIMEOUT;
     config->seed = time(NULL);
     config->view_path = NULL;
+    config->record_path = NULL;
     config->player_count = 0;
+    config->turbo = false;
+    config->summary = false;
+    config->max_moves = 0;
+    config->budget_ms = 0;
+    config->sync_rwsem = false;
+    config->compact = false;
+    config->spectate = false;
+    config->fps = VIEW_DEFAULT_FPS;
+    config->transport_shm = false;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
@@ -121,9 +253,64 @@ void parser(master_config_t* config, int argc, char *argv[]){
             config->seed = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
             config->view_path = argv[++i];
+        } else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--record") == 0) && i + 1 < argc) {
+            config->record_path = argv[++i];
+        } else if ((strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--game-id") == 0) && i + 1 < argc) {
+            const char* game_id = argv[++i];
+            char pid_id[ARG_BUFFER_SIZE];
+            if (strcmp(game_id, "auto") == 0) { // sufijo derivado del pid del master
+                snprintf(pid_id, sizeof(pid_id), "%ld", (long)getpid());
+                game_id = pid_id;
+            }
+            if (!is_valid_game_id(game_id)) {
+                fprintf(stderr, "Error: game-id invalido (hasta %d caracteres [A-Za-z0-9_-])\n", GAME_ID_MAX_LENGTH);
+                exit(EXIT_FAILURE);
+            }
+            setenv(GAME_ID_ENV, game_id, 1); // lo heredan jugadores y vista
+        } else if (strcmp(argv[i], "--turbo") == 0) {
+            config->turbo = true;
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            config->compact = true;
+        } else if (strcmp(argv[i], "--spectate") == 0) {
+            config->spectate = true;
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            config->fps = atoi(argv[++i]);
+            if (config->fps < 1) config->fps = 1;
+            if (config->fps > VIEW_MAX_FPS) config->fps = VIEW_MAX_FPS;
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            config->budget_ms = atol(argv[++i]);
+            if (config->budget_ms < 0) config->budget_ms = 0;
+        } else if (strcmp(argv[i], "--max-moves") == 0 && i + 1 < argc) {
+            config->max_moves = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--summary") == 0) {
+            config->summary = true;
+        } else if (strcmp(argv[i], "--sync") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "rwsem") == 0) {
+                config->sync_rwsem = true;
+            } else if (strcmp(argv[i], "seqlock") == 0) {
+                config->sync_rwsem = false;
+            } else {
+                fprintf(stderr, "Error: --sync debe ser seqlock o rwsem\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--transport") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], TRANSPORT_SHM) == 0) {
+                config->transport_shm = true;
+            } else if (strcmp(argv[i], "pipe") == 0) {
+                config->transport_shm = false;
+            } else {
+                fprintf(stderr, "Error: --transport debe ser pipe o shm\n");
+                exit(EXIT_FAILURE);
+            }
         } else if (strcmp(argv[i], "-p") == 0) {
 
-            while (i + 1 < argc && argv[i + 1][0] != '-' && config->player_count < MAX_PLAYERS) {
+            while (i + 1 < argc && argv[i + 1][0] != '-') {
+                if (config->player_count == MAX_PLAYERS) {
+                    fprintf(stderr, "Error: Se admiten como maximo %d jugadores\n", MAX_PLAYERS);
+                    exit(EXIT_FAILURE);
+                }
                 config->player_paths[config->player_count++] = argv[++i];
             }
         }
@@ -133,52 +320,126 @@ void parser(master_config_t* config, int argc, char *argv[]){
         fprintf(stderr, "Error: Se requiere al menos un jugador (-p)\n");
         exit(EXIT_FAILURE);
     }
+    const char* inherited_id = getenv(GAME_ID_ENV);
+    if (inherited_id && inherited_id[0] != '\0' && !is_valid_game_id(inherited_id)) {
+        fprintf(stderr, "Error: %s invalido\n", GAME_ID_ENV);
+        exit(EXIT_FAILURE);
+    }
+    if (config->turbo && config->view_path && !config->spectate) {
+        fprintf(stderr, "Error: El modo turbo solo admite vista como espectador (-v con --spectate)\n");
+        exit(EXIT_FAILURE);
+    }
+    if (config->compact && config->player_count > MAX_COMPACT_PLAYERS) {
+        fprintf(stderr, "Error: El tablero compacto admite como maximo %d jugadores\n", MAX_COMPACT_PLAYERS);
+        exit(EXIT_FAILURE);
+    }
+    if (config->player_count > config->width * config->height) {
+        fprintf(stderr, "Error: El tablero no tiene lugar para %d jugadores\n", config->player_count);
+        exit(EXIT_FAILURE);
+    }
+    // Los jugadores eligen el transporte segun el entorno que heredan
+    if (config->transport_shm) {
+        setenv(TRANSPORT_ENV, TRANSPORT_SHM, 1);
+    } else {
+        unsetenv(TRANSPORT_ENV);
+    }
 }
 
 int setup_shared_memory(master_config_t* config) {
-    size_t state_size = sizeof(game_state_t) + (config->width * config->height * sizeof(int));
+    unsigned char cell_bytes = config->compact ? COMPACT_CELL_BYTES : sizeof(int);
+    size_t state_size = game_state_size(config->width, config->height, config->player_count, cell_bytes);
+    size_t sync_size = game_sync_size(config->player_count);
 
     state_shm_fd = create_shared_memory(GAME_STATE_SHM, state_size);
-    if(state_shm_fd == -1) return -1;
+    if(state_shm_fd < 0){
+        state_shm_fd = -1;
+        return -1;
+    }
 
     game_state = (game_state_t*)attach_shared_memory(state_shm_fd, state_size, false);
     if(game_state == NULL) return -1;
+    initialize_game_state(game_state, config->width, config->height, config->player_count, cell_bytes, config->seed);
 
-    sync_shm_fd = create_shared_memory(GAME_SYNC_SHM, sizeof(game_sync_t));
-    if (sync_shm_fd == -1) return -1;
+    sync_shm_fd = create_shared_memory(GAME_SYNC_SHM, sync_size);
+    if (sync_shm_fd < 0){
+        sync_shm_fd = -1;
+        return -1;
+    }
 
-    game_sync = (game_sync_t*) attach_shared_memory(sync_shm_fd, sizeof(game_sync_t), false);
+    game_sync = (game_sync_t*) attach_shared_memory(sync_shm_fd, sync_size, false);
     if(game_sync == NULL) return -1;
-    
-    game_state->width = config->width;
-    game_state->height = config->height;
-    game_state->player_count = config->player_count;
-    game_state->is_game_over = false;
+    game_sync->player_count = 0; // initialize_semaphores lo completa
 
-    for (int i = 0; i < config->player_count; i++) {
-        snprintf(game_state->players[i].name, MAX_NAME_LENGTH, "Player%d", i);
-        game_state->players[i].score = 0;
-        game_state->players[i].invalid_moves = 0;
-        game_state->players[i].valid_moves = 0;
-        game_state->players[i].blocked = false;
-        game_state->players[i].pid = 0;
+    initialize_semaphores(game_sync, config->player_count);
+
+    // Las estadisticas son solo para mirar: sin ellas la partida se juega igual
+    stats_size = game_stats_size(config->player_count);
+    stats_shm_fd = create_shared_memory(GAME_STATS_SHM, stats_size);
+    if (stats_shm_fd < 0) {
+        stats_shm_fd = -1;
+        fprintf(stderr, "Aviso: la partida sigue sin estadisticas por etapa\n");
+    } else {
+        game_stats = (game_stats_t*)attach_shared_memory(stats_shm_fd, stats_size, false);
+        if (game_stats) game_stats_init(game_stats, config->player_count);
     }
-    initialize_board(game_state, config->seed);
-    place_players_on_board(game_state);
 
-    initialize_semaphores(game_sync, config->player_count);
+    if (config->transport_shm) {
+        moves_size = move_channels_size(config->player_count);
+        moves_shm_fd = create_shared_memory(GAME_MOVES_SHM, moves_size);
+        if (moves_shm_fd < 0) {
+            moves_shm_fd = -1;
+            return -1;
+        }
+        move_channels = (move_channels_t*)attach_shared_memory(moves_shm_fd, moves_size, false);
+        if (move_channels == NULL) return -1;
+        move_channels_init(move_channels, config->player_count);
+    }
 
    return 0;
 }
 
-pid_t create_player_process(const char* player_path, int player_id, master_config_t* config){
+// Separa "ruta [opciones...]" sobre spec (que se modifica) y arma el argv del jugador:
+// ruta, ancho, alto y luego sus opciones. Devuelve la cantidad de opciones o -1 si sobran.
+static int build_player_argv(char* spec, char* width_str, char* height_str, char* args[]) {
+    char* save = NULL;
+    args[0] = strtok_r(spec, " ", &save);
+    args[1] = width_str;
+    args[2] = height_str;
+    int extra = 0;
+    char* token;
+    while ((token = strtok_r(NULL, " ", &save)) != NULL) {
+        if (extra == MAX_PLAYER_ARGS) {
+            return -1;
+        }
+        args[3 + extra++] = token;
+    }
+    args[3 + extra] = NULL;
+    return extra;
+}
+
+pid_t create_player_process(const char* player_spec, int player_id, master_config_t* config){
+    char spec[PLAYER_SPEC_MAX_LENGTH];
+    char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE];
+    char* args[MAX_PLAYER_ARGS + 4];
+    if (snprintf(width_str, sizeof(width_str), "%d", config->width) < 0 || snprintf(height_str, sizeof(height_str), "%d", config->height) < 0){
+        perror("Error formateando argumentos");
+        return ERR_GENERIC;
+    }
+    if ((size_t)snprintf(spec, sizeof(spec), "%s", player_spec) >= sizeof(spec) || build_player_argv(spec, width_str, height_str, args) < 0 || args[0] == NULL) {
+        fprintf(stderr, "Jugador invalido: %s\n", player_spec);
+        return ERR_GENERIC;
+    }
+    const char* player_path = args[0];
     if (!is_executable_file(player_path)) {
             perror("El player path no es valido");
             return ERR_GENERIC;
     }
 
-    int pipefd[2];
-    if(pipe(pipefd) == -1){
+    int pipefd[2] = { -1, -1 };
+    if (move_channels) {
+        // Vivo desde antes del fork: si el hijo muere sin avisar, el máster lo nota al recolectarlo
+        move_channels->channels[player_id].alive = 1;
+    } else if(pipe(pipefd) == -1){
         perror("Error al crear pipe");
         return ERR_PIPE;
     }
@@ -186,32 +447,34 @@ pid_t create_player_process(const char* player_path, int player_id, master_confi
     pid_t pid = fork();
     if(pid == -1){
         perror("Error al crear proceso");
-        close(pipefd[0]);
-        close(pipefd[1]);
+        if (pipefd[0] != -1) {
+            close(pipefd[0]);
+            close(pipefd[1]);
+        }
         return ERR_FORK;
     }
 
     if(pid == 0){
-        close(pipefd[0]);
-        if(dup2(pipefd[1], STDOUT_FILENO)<0){
-            perror("Error haciendo el dup");
+        // El hijo publica su pid antes del exec para que el jugador siempre encuentre su id
+        game_state->players[player_id].pid = getpid();
+        if (pipefd[0] != -1) { // Con anillos la salida estandar queda como esta
+            close(pipefd[0]);
+            if(dup2(pipefd[1], STDOUT_FILENO)<0){
+                perror("Error haciendo el dup");
+                close(pipefd[1]);
+                exit(EXIT_FAILURE);
+            }
             close(pipefd[1]);
-            exit(EXIT_FAILURE);
         }
-        close(pipefd[1]);
-        char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE];
-        if (snprintf(width_str, sizeof(width_str), "%d", config->width) < 0 || snprintf(height_str, sizeof(height_str), "%d", config->height) < 0){
-            perror("Error formateando argumentos");
-            exit(EXIT_FAILURE);
-        }
-        
-        execl(player_path, player_path, width_str, height_str, NULL);
-        perror("Error haciendo el execl");//no deberia llegar
+
+        execv(player_path, args);
+        perror("Error haciendo el execv");//no deberia llegar
         exit(EXIT_FAILURE);
     }
-    close(pipefd[1]);
+    if (pipefd[1] != -1) close(pipefd[1]);
 
     players[player_id].pid = pid;
+    if (game_stats) game_stats->players[player_id].pid = pid;
     players[player_id].pipe_fd = pipefd[0];
     players[player_id].active = true;
     game_state->players[player_id].pid = pid;
@@ -225,14 +488,19 @@ pid_t create_view_process(const char* view_path, master_config_t *config){
         perror("Error al crear proceso");
         return ERR_FORK;
     }else if(pid == 0){
-        char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE];
+        char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE], fps_str[ARG_BUFFER_SIZE];
         if (snprintf(width_str, sizeof(width_str), "%d", config->width) < 0 ||
-            snprintf(height_str, sizeof(height_str), "%d", config->height) < 0) {
+            snprintf(height_str, sizeof(height_str), "%d", config->height) < 0 ||
+            snprintf(fps_str, sizeof(fps_str), "%d", config->fps) < 0) {
             perror("Error formateando argumentos");
             exit(EXIT_FAILURE);
         }
         
-        execl(view_path, view_path, width_str, height_str, NULL);
+        if (config->spectate) {
+            execl(view_path, view_path, width_str, height_str, "--fps", fps_str, NULL);
+        } else {
+            execl(view_path, view_path, width_str, height_str, NULL);
+        }
         perror("Error haciendo el execl");//no deberia llegar
         exit(EXIT_FAILURE);
     }
@@ -250,17 +518,219 @@ void signal_handler(int sig __attribute__((unused))) {
 }
 
 
-static void game_loop(master_config_t *config) {
-    fd_set read_fds;
-    struct timeval timeout;
-    int max_fd = 0;
-    for(int i = 0; i < config->player_count; i++) {
-        if (players[i].pipe_fd > max_fd) {
-            max_fd = players[i].pipe_fd;
+// Toda escritura del estado pasa por el seqlock; con --sync rwsem ademas se excluye a los
+// lectores que usan el protocolo de semaforos original
+static void begin_state_update(const master_config_t* config) {
+    if (config->sync_rwsem) writer_enter(game_sync);
+    state_write_begin(game_state);
+}
+
+static void end_state_update(const master_config_t* config) {
+    state_write_end(game_state); // Tambien avanza el contador de cuadros de los espectadores
+    if (config->sync_rwsem) writer_exit(game_sync);
+}
+
+static void record_latency(uint64_t latency_ns) {
+    if (turbo_stats.count == turbo_stats.capacity) {
+        size_t capacity = turbo_stats.capacity ? turbo_stats.capacity * 2 : INITIAL_LATENCY_SAMPLES;
+        uint64_t* samples = realloc(turbo_stats.latencies_ns, capacity * sizeof(uint64_t));
+        if (!samples) return; // sin memoria se pierde la muestra, no la partida
+        turbo_stats.latencies_ns = samples;
+        turbo_stats.capacity = capacity;
+    }
+    turbo_stats.latencies_ns[turbo_stats.count++] = latency_ns;
+}
+
+static void print_turbo_report(void) {
+    double wall_s = (double)(turbo_stats.end_ns - turbo_stats.start_ns) / NS_PER_SEC;
+    double moves_per_sec = wall_s > 0 ? turbo_stats.count / wall_s : 0;
+    uint64_t p50 = percentile_ns(turbo_stats.latencies_ns, turbo_stats.count, 50);
+    uint64_t p99 = percentile_ns(turbo_stats.latencies_ns, turbo_stats.count, 99);
+    printf("Turbo: movimientos=%zu tiempo_s=%.6f mov_por_s=%.1f p50_us=%.2f p99_us=%.2f\n",
+           turbo_stats.count, wall_s, moves_per_sec, p50 / 1000.0, p99 / 1000.0);
+    free(turbo_stats.latencies_ns);
+    turbo_stats.latencies_ns = NULL;
+}
+
+static void post_turn(const master_config_t* config, int id) {
+    turn_posted_ns[id] = monotonic_ns();
+    players[id].deadline_ns = turn_posted_ns[id] + (uint64_t)config->budget_ms * MS_TO_NS;
+    if (move_channels) {
+        move_channel_post_turn(move_channels, id);
+    } else {
+        sem_post(&game_sync->player_turn[id]);   // le permite al jugador hacer su movimiento
+    }
+}
+
+// Hay un movimiento (o un EOF) esperando al máster
+static bool move_pending(int id) {
+    if (move_channels) return move_channel_pending(move_channels, id);
+    struct pollfd pending = { .fd = players[id].pipe_fd, .events = POLLIN };
+    return poll(&pending, 1, 0) > 0;
+}
+
+// Como read() sobre el pipe: 1 con un movimiento, 0 si el jugador termino y -1 con errno
+static ssize_t read_move(int id, unsigned char* move) {
+    if (!move_channels) return read(players[id].pipe_fd, move, MOVE_DATA_SIZE);
+    if (move_channel_pop(move_channels, id, move)) return MOVE_DATA_SIZE;
+    if (!move_channel_pending(move_channels, id)) {
+        errno = EAGAIN;
+        return -1;
+    }
+    // alive ya es 0, pero lo ultimo que escribio antes de terminar todavia cuenta
+    return move_channel_pop(move_channels, id, move) ? MOVE_DATA_SIZE : 0;
+}
+
+// Cobra como invalido el turno de cada jugador cuyo presupuesto vencio sin que haya contestado;
+// tras MOVE_BUDGET_MAX_MISSES vencimientos seguidos queda bloqueado. Devuelve el proximo
+// vencimiento pendiente (UINT64_MAX si no hay).
+static uint64_t expire_budgets(const master_config_t* config, uint64_t now_ns) {
+    uint64_t next_ns = UINT64_MAX;
+    for (int id = 0; id < config->player_count; id++) {
+        if (!players[id].watched) continue;
+        if (players[id].deadline_ns > now_ns) {
+            if (players[id].deadline_ns < next_ns) next_ns = players[id].deadline_ns;
+            continue;
+        }
+        // El máster pudo estar ocupado (vista, -d): si el movimiento ya esta en el pipe, llego a tiempo
+        if (move_pending(id)) continue;
+
+        bool blocked = ++players[id].misses >= MOVE_BUDGET_MAX_MISSES;
+        begin_state_update(config);
+        game_state->players[id].invalid_moves++;
+        if (blocked) game_state->players[id].blocked = true;
+        end_state_update(config);
+        replay_log_move(&replay_log, id, 0, REPLAY_DEADLINE_MISSED | (blocked ? REPLAY_PLAYER_LEFT : 0), now_ns);
+        players[id].late = true; // Sigue con el turno: lo que conteste se descarta
+        players[id].deadline_ns = now_ns + (uint64_t)config->budget_ms * MS_TO_NS;
+        if (blocked) {
+            retire_player(id, false);
+        } else if (players[id].deadline_ns < next_ns) {
+            next_ns = players[id].deadline_ns;
+        }
+    }
+    return next_ns;
+}
+
+// Lee y procesa el movimiento pendiente del jugador id. Devuelve true si se consumio un movimiento.
+static bool handle_player_move(const master_config_t* config, int id, const struct timespec* delay_ts, uint64_t* last_move_ns) {
+    unsigned char move;
+    ssize_t n = read_move(id, &move);
+    uint64_t now_ns = monotonic_ns();
+
+    if (n == 0) { // EOF: el jugador termino
+        replay_log_move(&replay_log, id, 0, REPLAY_PLAYER_LEFT, now_ns);
+        game_state->players[id].blocked = true;
+        retire_player(id, true);
+        return false;
+    }
+    if (n < 0) {
+        if (errno == EINTR || errno == EAGAIN) return false; // sigue listo, epoll lo vuelve a reportar
+        // actuo como si el jugador se fue
+        replay_log_move(&replay_log, id, 0, REPLAY_PLAYER_LEFT, now_ns);
+        game_state->players[id].blocked = true;
+        retire_player(id, true);
+        return false;
+    }
+    if (config->turbo) {
+        record_latency(now_ns - turn_posted_ns[id]);
+    }
+    record_stage(id, STATS_THINK, now_ns - turn_posted_ns[id]);
+
+    if (players[id].late) {
+        // Llego despues de su presupuesto, que ya se cobro como invalido: no se aplica
+        players[id].late = false;
+        post_turn(config, id);
+        return true;
+    }
+    players[id].misses = 0;
+    
+    uint64_t lock_ns = monotonic_ns();
+    begin_state_update(config);
+    uint64_t critical_ns = monotonic_ns();
+
+    board_t board = game_board(game_state);
+    bool valid = is_valid_move(&board, move, game_state->players[id].x, game_state->players[id].y, game_state->players[id].blocked);
+    if (valid) {
+        apply_move(game_state, id, move); //apply move icrementa valid_moves
+        *last_move_ns = now_ns;
+    } else {
+        game_state->players[id].invalid_moves++;
+    }
+    game_state->players[id].blocked = is_player_blocked(&board, game_state->players[id].x, game_state->players[id].y);
+    end_state_update(config);
+    uint64_t done_ns = monotonic_ns();
+    record_stage(id, STATS_LOCK_WAIT, critical_ns - lock_ns);
+    record_stage(id, STATS_CRITICAL, done_ns - critical_ns);
+    if (game_stats) __atomic_store_n(&game_stats->updated_ns, done_ns, __ATOMIC_RELAXED);
+    replay_log_move(&replay_log, id, move, valid ? REPLAY_MOVE_VALID : 0, now_ns);
+
+    if (game_state->players[id].blocked) {
+        retire_player(id, false);
+    }
+
+    post_turn(config, id);
+
+    if (!config->turbo) {
+        if (view_pid > 0 && !config->spectate) {
+            uint64_t view_ns = monotonic_ns();
+            notify_view_and_wait_ms(config, config->delay);
+            record_stage(id, STATS_VIEW, monotonic_ns() - view_ns);
+        }
+        nanosleep(delay_ts, NULL);
+    }
+    return true;
+}
+
+// Jugadores en juego con algo para leer en su anillo
+static int collect_pending(const master_config_t* config, int* ids) {
+    int count = 0;
+    for (int id = 0; id < config->player_count; id++) {
+        if (players[id].watched && move_channel_pending(move_channels, id)) ids[count++] = id;
+    }
+    return count;
+}
+
+// Un jugador que muere sin llegar a move_channel_close no deja EOF: se lo recolecta y se lo da por terminado
+static void reap_dead_players(const master_config_t* config) {
+    for (int id = 0; id < config->player_count; id++) {
+        if (players[id].watched && !players[id].reaped && waitpid(players[id].pid, &players[id].status, WNOHANG) == players[id].pid) {
+            players[id].reaped = true;
+            move_channel_mark_dead(move_channels, id);
         }
     }
+}
+
+// Espera a lo sumo wait_ns a que algun jugador tenga un movimiento (o un EOF) y deja sus ids en
+// ids. Devuelve cuantos hay, o -1 con errno como epoll_wait.
+static int wait_for_moves(const master_config_t* config, int* ids, uint64_t wait_ns) {
+    if (!move_channels) {
+        struct epoll_event events[MAX_PLAYERS];
+        int ready_count = epoll_wait(epoll_fd, events, config->player_count, (int)((wait_ns + MS_TO_NS - 1) / MS_TO_NS));
+        for (int i = 0; i < ready_count; i++) ids[i] = (int)events[i].data.u32;
+        return ready_count;
+    }
+    // posted se lee antes de revisar los anillos: lo que se publique despues despierta al futex
+    uint32_t seen = __atomic_load_n(&move_channels->posted, __ATOMIC_ACQUIRE);
+    int ready_count = collect_pending(config, ids);
+    if (ready_count > 0) return ready_count;
+    uint64_t liveness_ns = (uint64_t)MOVE_CHANNEL_LIVENESS_MS * MS_TO_NS;
+    if (!move_channels_wait(move_channels, seen, wait_ns < liveness_ns ? wait_ns : liveness_ns)) {
+        reap_dead_players(config);
+    }
+    return collect_pending(config, ids);
+}
+
+static void game_loop(master_config_t *config) {
+    int ready[MAX_PLAYERS];
+
+    if (watch_players(config) != 0) {
+        return;
+    }
     
-    notify_view_and_wait_ms(config->delay);
+    if (!config->turbo) {
+        notify_view_and_wait_ms(config, config->delay);
+    }
 
     struct timespec delay_ts = {
         .tv_sec  = config->delay / MS_TO_SEC,
@@ -268,7 +738,17 @@ static void game_loop(master_config_t *config) {
     };
 
     int current_player = 0;
-    time_t last_move = time(NULL);
+    unsigned long moves = 0;
+    uint64_t timeout_ns = (uint64_t)config->timeout * NS_PER_SEC;
+    uint64_t last_move_ns = monotonic_ns();
+    turbo_stats.start_ns = last_move_ns;
+    // Los semaforos de turno arrancan en 1: el primer turno cuenta desde el inicio del juego
+    for (int i = 0; i < config->player_count; i++) {
+        turn_posted_ns[i] = last_move_ns;
+        // El primer turno incluye arrancar el proceso: se le suma un margen al presupuesto
+        players[i].deadline_ns = last_move_ns + (uint64_t)(config->budget_ms + MOVE_BUDGET_STARTUP_MS) * MS_TO_NS;
+    }
+    uint64_t next_deadline_ns = UINT64_MAX;
 
 
     while (!game_state->is_game_over) {
@@ -277,99 +757,110 @@ static void game_loop(master_config_t *config) {
             break;
         }
 
-        if(time(NULL) - last_move > config->timeout) {
+        if (config->budget_ms) {
+            next_deadline_ns = expire_budgets(config, monotonic_ns());
+        }
+
+        uint64_t idle_ns = monotonic_ns() - last_move_ns;
+        if(idle_ns > timeout_ns) {
             break;
         }
 
-        if (all_players_blocked_or_inactive(config)) {
+        if (all_players_blocked_or_inactive()) {
             break;
         }
 
-        FD_ZERO(&read_fds);
-        
-        for(int i = 0; i < config->player_count; i++) {
-            if (players[i].active && !game_state->players[i].blocked) {
-                FD_SET(players[i].pipe_fd, &read_fds);
-            }
+        if (config->max_moves && moves >= config->max_moves) {
+            break;
         }
-        
-        timeout.tv_sec = config->timeout;
-        timeout.tv_usec = 0;
 
-        int ready = select(max_fd + 1, &read_fds, NULL, NULL, &timeout);
-        if(ready == -1){
+        // Se duerme como maximo hasta que venza el timeout de inactividad o el primer presupuesto
+        uint64_t wait_ns = timeout_ns - idle_ns;
+        if (next_deadline_ns != UINT64_MAX) {
+            uint64_t now_ns = monotonic_ns();
+            uint64_t until_deadline_ns = next_deadline_ns > now_ns ? next_deadline_ns - now_ns : 0;
+            if (until_deadline_ns < wait_ns) wait_ns = until_deadline_ns;
+        }
+        int ready_ids[MAX_PLAYERS];
+        int ready_count = wait_for_moves(config, ready_ids, wait_ns);
+        if(ready_count == -1){
             if (errno == EINTR) {
                 if(interrupted) {
                     break;
                 }
                 continue;
             }
-                perror("Error en select");
+                perror("Error en epoll_wait");
                 break;
         }
-        if (ready == 0) {
+        if (ready_count == 0) {
             continue; 
         }
 
-        bool processed_move = false;
-        for(int tries=0; tries<config->player_count && !processed_move; tries++) {
-            int id = (current_player + tries) % config->player_count;
-                        
-            if (!players[id].active || game_state->players[id].blocked) {
-                continue;
-            }
-            if (!FD_ISSET(players[id].pipe_fd, &read_fds)) {
-                continue;
+        // Se atienden todos los listos en orden round-robin a partir de current_player
+        for (int i = 0; i < ready_count; i++) {
+            int id = ready_ids[i];
+            int rank = (id - current_player + config->player_count) % config->player_count;
+            int j = i;
+            while (j > 0 && (ready[j - 1] - current_player + config->player_count) % config->player_count > rank) {
+                ready[j] = ready[j - 1];
+                j--;
             }
+            ready[j] = id;
+        }
 
-            unsigned char move;
-            ssize_t n = read(players[id].pipe_fd, &move, 1);
-
-            if (n == 0) { // EOF: el jugador termino
-                game_state->players[id].blocked = true;
-                players[id].active = false;
-                close(players[id].pipe_fd);
-                players[id].pipe_fd = -1;
+        int last_served = -1;
+        for (int i = 0; i < ready_count && !interrupted; i++) {
+            int id = ready[i];
+            if (!players[id].watched) {
                 continue;
             }
-            if (n < 0) {
-                if (errno == EINTR) continue; //?
-                // actuo como si el jugador se fue
-                game_state->players[id].blocked = true;
-                players[id].active = false;
-                close(players[id].pipe_fd);
-                players[id].pipe_fd = -1;
-                continue;
+            if (config->max_moves && moves >= config->max_moves) {
+                break;
             }
-            
-            sem_wait(&game_sync->writer_mutex);
-            sem_wait(&game_sync->state_mutex);
-
-            if (is_valid_move(game_state->board, move, game_state->players[id].x, game_state->players[id].y, game_state->players[id].blocked, game_state->width, game_state->height)) {
-                apply_move(game_state, id, move); //apply move icrementa valid_moves
-                last_move = time(NULL);
-            } else {
-                game_state->players[id].invalid_moves++;
+            if (handle_player_move(config, id, &delay_ts, &last_move_ns)) {
+                last_served = id;
+                moves++;
             }
-            game_state->players[id].blocked = is_player_blocked(game_state->board, game_state->players[id].x, game_state->players[id].y, game_state->width, game_state->height);
-            sem_post(&game_sync->state_mutex);
-            sem_post(&game_sync->writer_mutex);
-
-            sem_post(&game_sync->player_turn[id]);   // le permite al jugador hacer su movimiento
-
-            notify_view_and_wait_ms(config->delay);
-            nanosleep(&delay_ts, NULL);
-
-            processed_move = true;
-            current_player = (id + 1) % config->player_count;
+        }
+        if (last_served != -1) {
+            current_player = (last_served + 1) % config->player_count;
         }
     }
+    turbo_stats.end_ns = monotonic_ns();
 
-    sem_wait(&game_sync->state_mutex);
+    begin_state_update(config);
     game_state->is_game_over = true;
-    sem_post(&game_sync->state_mutex);
+    end_state_update(config);
+    if (game_stats) __atomic_store_n(&game_stats->finished, true, __ATOMIC_RELEASE);
 
-    notify_view_and_wait_ms(FINAL_VIEW_DISPLAY_MS);
+    if (config->spectate) {
+        wait_view_exit_ms(FINAL_VIEW_DISPLAY_MS); // La partida ya termino: se le da tiempo a mostrar el cartel
+    } else {
+        notify_view_and_wait_ms(config, FINAL_VIEW_DISPLAY_MS);
+    }
+}
+
+// Recolecta sin bloquear a los hijos que ya terminaron. Devuelve true si no queda ninguno vivo.
+static bool reap_finished_processes(master_config_t* config) {
+    bool all_done = true;
+    for (int i = 0; i < config->player_count; i++) {
+        if (players[i].pid > 0 && !players[i].reaped) {
+            if (waitpid(players[i].pid, &players[i].status, WNOHANG) == players[i].pid) {
+                players[i].reaped = true;
+            } else {
+                all_done = false;
+            }
+        }
+    }
+    if (view_pid > 0 && !view_reaped) {
+        if (waitpid(view_pid, &view_status, WNOHANG) == view_pid) {
+            view_reaped = true;
+        } else {
+            all_done = false;
+        }
+    }
+    return all_done;
 }
 
 void terminate_all_processes(master_config_t* config){
@@ -388,41 +879,37 @@ void terminate_all_processes(master_config_t* config){
         kill(view_pid, SIGTERM);
     }
     
-    // Dar tiempo para terminación graceful
-    sleep(GRACEFUL_TERMINATION_WAIT_SEC);
+    // Dar tiempo para terminación graceful, sin esperar de mas si ya terminaron todos
+    struct timespec poll_ts = { .tv_sec = 0, .tv_nsec = REAP_POLL_MS * MS_TO_NS };
+    uint64_t deadline_ns = monotonic_ns() + (uint64_t)GRACEFUL_TERMINATION_WAIT_SEC * NS_PER_SEC;
+    while (!reap_finished_processes(config) && monotonic_ns() < deadline_ns) {
+        nanosleep(&poll_ts, NULL);
+    }
     
     // Forzar terminación si es necesario
     for (int i = 0; i < config->player_count; i++) {
-        if (players[i].pid > 0) {
+        if (players[i].pid > 0 && !players[i].reaped) {
+            printf("Forzando terminación del jugador %d\n", i);
             kill(players[i].pid, SIGKILL);
         }
     }
     
-    if (view_pid > 0) {
+    if (view_pid > 0 && !view_reaped) {
+        printf("Forzando terminación de la vista\n");
         kill(view_pid, SIGKILL);
     }
 }
 
 void wait_for_processes(master_config_t* config){
-    int status;
-    
     printf("Esperando terminación de procesos...\n");
     
-    // Esperar jugadores con timeout
     for(int i = 0; i < config->player_count; i++){
         if (players[i].pid > 0) {
-            pid_t result = waitpid(players[i].pid, &status, WNOHANG);
-            if (result == 0) {
-                // Proceso aún corriendo, dar más tiempo
-                sleep(1);
-                result = waitpid(players[i].pid, &status, WNOHANG);
-                if(result == 0){
-                    printf("Forzando terminación del jugador %d\n", i);
-                    kill(players[i].pid, SIGKILL);
-                    waitpid(players[i].pid, &status, 0);
-                }
+            if (!players[i].reaped) {
+                waitpid(players[i].pid, &players[i].status, 0);
+                players[i].reaped = true;
             }
-            
+            int status = players[i].status;
             if(WIFEXITED(status)){
                 printf("Jugador %d terminó con código %d, puntaje: %u\n", i, WEXITSTATUS(status), game_state->players[i].score);
             }else if(WIFSIGNALED(status)){
@@ -431,27 +918,29 @@ void wait_for_processes(master_config_t* config){
         }
     }
     
-    // Esperar vista con timeout
     if(view_pid > 0){
-        pid_t result = waitpid(view_pid, &status, WNOHANG);
-        if(result == 0){
-            sleep(1);
-            result = waitpid(view_pid, &status, WNOHANG);
-            if(result == 0){
-                printf("Forzando terminación de la vista\n");
-                kill(view_pid, SIGKILL);
-                waitpid(view_pid, &status, 0);
-            }
+        if (!view_reaped) {
+            waitpid(view_pid, &view_status, 0);
+            view_reaped = true;
         }
-        
-        if(WIFEXITED(status)){
-            printf("Vista terminó con código %d\n", WEXITSTATUS(status));
-        }else if (WIFSIGNALED(status)){
-            printf("Vista terminó por señal %d\n", WTERMSIG(status));
+        if(WIFEXITED(view_status)){
+            printf("Vista terminó con código %d\n", WEXITSTATUS(view_status));
+        }else if (WIFSIGNALED(view_status)){
+            printf("Vista terminó por señal %d\n", WTERMSIG(view_status));
         }
     }
 }
 
+// Una linea CSV por jugador para herramientas externas (p. ej. bin/tournament)
+static void print_summary(master_config_t* config) {
+    int winner = determine_winner(game_state);
+    for (int i = 0; i < config->player_count; i++) {
+        player_t* p = &game_state->players[i];
+        printf("%s,%d,%u,%u,%u,%d\n", SUMMARY_PREFIX, i, p->score, p->valid_moves, p->invalid_moves, i == winner);
+    }
+    fflush(stdout);
+}
+
 int main(int argc, char *argv[]){
     int exit_code = EXIT_SUCCESS;
     master_config_t config;
@@ -469,7 +958,7 @@ int main(int argc, char *argv[]){
         goto clear;
     }
     for(int i=0; i<config.player_count; i++){
-        if(create_player_process(config.player_paths[i], i, &config) == -1){
+        if(create_player_process(config.player_paths[i], i, &config) < 0){
             fprintf(stderr, "Error al crear proceso jugador %d\n", i);
             exit_code = EXIT_FAILURE;
             goto clear;
@@ -484,7 +973,21 @@ int main(int argc, char *argv[]){
             goto clear;
         }
     }
+    // El escritor del replay arranca despues de los fork: los hijos no heredan su hilo
+    if (config.record_path && replay_log_open(&replay_log, config.record_path, game_state, config.seed) != 0) {
+        exit_code = EXIT_FAILURE;
+        goto clear;
+    }
     game_loop(&config);
+    if (replay_log_close(&replay_log, game_state) != 0) {
+        exit_code = EXIT_FAILURE;
+    }
+    if (config.turbo) {
+        print_turbo_report();
+    }
+    if (config.summary) {
+        print_summary(&config);
+    }
 
     clear:
     terminate_all_processes(&config);
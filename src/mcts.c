@@ -0,0 +1,364 @@
+#define _GNU_SOURCE // sched_getaffinity
+#include "../include/mcts.h"
+#include "../include/search.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include "../include/timing.h"
+#include <math.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MCTS_PASS NUM_DIRECTIONS
+#define MCTS_MAX_PLIES (MCTS_HORIZON_ROUNDS * MCTS_MAX_PLAYERS)
+#define XORSHIFT_SEED_MIX 0x9E3779B97F4A7C15ULL
+
+typedef struct {
+    int x, y, value;
+} mcts_undo_t;
+
+static inline uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static size_t plane_copy_bytes(const board_t* board) {
+    return (size_t)(board->height + 2) * board->free_stride * sizeof(uint64_t);
+}
+
+static void* worker_main(void* arg);
+
+int mcts_default_threads(void) {
+    // La afinidad y no los cores en linea: bin/tournament fija cada partida a un solo core
+    cpu_set_t cpus;
+    int count = sched_getaffinity(0, sizeof(cpus), &cpus) == 0 ? CPU_COUNT(&cpus) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) count = 1;
+    return count > MCTS_DEFAULT_MAX_THREADS ? MCTS_DEFAULT_MAX_THREADS : count;
+}
+
+int mcts_init(mcts_t* mcts, const board_t* board, int threads) {
+    memset(mcts, 0, sizeof(*mcts));
+    mcts->threads = threads < 1 ? 1 : threads;
+    pthread_mutex_init(&mcts->lock, NULL);
+    pthread_cond_init(&mcts->start, NULL);
+    pthread_cond_init(&mcts->done, NULL);
+    mcts->pending_full = true; // Las copias de los hilos todavia no tienen nada
+    mcts->workers = calloc((size_t)mcts->threads, sizeof(mcts_worker_t));
+    mcts->pending = malloc(MCTS_PENDING_CELLS * sizeof(unsigned int));
+    if (!mcts->workers || !mcts->pending) {
+        mcts_free(mcts);
+        return ERR_GENERIC;
+    }
+    for (int t = 0; t < mcts->threads; t++) {
+        mcts_worker_t* w = &mcts->workers[t];
+        w->owner = mcts;
+        w->board = *board;
+        w->board.cells = malloc(board_bytes(board->height, board->stride, board->cell_bytes));
+        w->board.free_bits = free_plane_alloc(board->width, board->height);
+        w->board.free_stride = free_plane_stride(board->width);
+        w->nodes = malloc(MCTS_MAX_NODES * sizeof(mcts_node_t));
+        w->rng = (monotonic_ns() ^ ((uint64_t)(t + 1) * XORSHIFT_SEED_MIX)) | 1;
+        if (!w->board.cells || !w->board.free_bits || !w->nodes) {
+            mcts_free(mcts);
+            return ERR_GENERIC;
+        }
+    }
+    // El hilo principal hace de worker 0; si un hilo no se puede crear, ese arbol no se usa
+    mcts->workers[0].started = true;
+    for (int t = 1; t < mcts->threads; t++) {
+        mcts->workers[t].started = pthread_create(&mcts->workers[t].thread, NULL, worker_main, &mcts->workers[t]) == 0;
+    }
+    return 0;
+}
+
+void mcts_free(mcts_t* mcts) {
+    if (!mcts->workers && !mcts->pending) {
+        return;
+    }
+    pthread_mutex_lock(&mcts->lock);
+    mcts->stop = true;
+    pthread_cond_broadcast(&mcts->start);
+    pthread_mutex_unlock(&mcts->lock);
+    for (int t = 0; mcts->workers && t < mcts->threads; t++) {
+        if (t > 0 && mcts->workers[t].started) {
+            pthread_join(mcts->workers[t].thread, NULL);
+        }
+        free(mcts->workers[t].board.cells);
+        free_plane_release(mcts->workers[t].board.free_bits);
+        free(mcts->workers[t].nodes);
+    }
+    free(mcts->workers);
+    free(mcts->pending);
+    mcts->workers = NULL;
+    mcts->pending = NULL;
+    pthread_cond_destroy(&mcts->done);
+    pthread_cond_destroy(&mcts->start);
+    pthread_mutex_destroy(&mcts->lock);
+}
+
+void mcts_observe(mcts_t* mcts, const unsigned int* changed, size_t count, bool full_copy) {
+    if (mcts->pending_full) {
+        return;
+    }
+    if (full_copy || mcts->pending_count + count > MCTS_PENDING_CELLS) {
+        mcts->pending_full = true;
+        return;
+    }
+    memcpy(mcts->pending + mcts->pending_count, changed, count * sizeof(unsigned int));
+    mcts->pending_count += count;
+}
+
+static void init_node(mcts_node_t* node, unsigned char move, unsigned char mover) {
+    node->first_child = -1;
+    node->child_count = 0;
+    node->move = move;
+    node->mover = mover;
+    node->visits = 0;
+    node->reward = 0.0;
+}
+
+// Crea un hijo por movimiento legal de quien mueve en el nodo (o uno solo para pasar)
+static bool expand(mcts_worker_t* w, int index, const int* x, const int* y) {
+    mcts_node_t* node = &w->nodes[index];
+    int count = w->owner->count;
+    unsigned char mask = legal_move_mask(&w->board, x[node->mover], y[node->mover]);
+    int children = mask ? __builtin_popcount(mask) : 1;
+    if (w->node_count + children > MCTS_MAX_NODES) {
+        return false;
+    }
+    unsigned char next = (unsigned char)((node->mover + 1) % count);
+    node->first_child = w->node_count;
+    node->child_count = (unsigned char)children;
+    if (!mask) {
+        init_node(&w->nodes[w->node_count++], MCTS_PASS, next);
+        return true;
+    }
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (mask & (1u << d)) {
+            init_node(&w->nodes[w->node_count++], (unsigned char)d, next);
+        }
+    }
+    return true;
+}
+
+static int select_child(const mcts_worker_t* w, const mcts_node_t* node) {
+    int best = node->first_child;
+    double best_value = -1.0;
+    double log_visits = log((double)node->visits + 1.0);
+    for (int c = node->first_child; c < node->first_child + node->child_count; c++) {
+        const mcts_node_t* child = &w->nodes[c];
+        if (child->visits == 0) {
+            return c;
+        }
+        double value = child->reward / child->visits + MCTS_EXPLORATION * sqrt(log_visits / child->visits);
+        if (value > best_value) {
+            best_value = value;
+            best = c;
+        }
+    }
+    return best;
+}
+
+static void play(mcts_worker_t* w, int mover, int move, int* x, int* y, int* gain, mcts_undo_t* undo) {
+    int nx = x[mover] + MOVE_DELTAS[move][0];
+    int ny = y[mover] + MOVE_DELTAS[move][1];
+    undo->x = nx;
+    undo->y = ny;
+    undo->value = board_cell(&w->board, nx, ny);
+    set_cell_owner(&w->board, nx, ny, w->owner->id[mover]);
+    gain[mover] += undo->value;
+    x[mover] = nx;
+    y[mover] = ny;
+}
+
+static int random_move(uint64_t* rng, unsigned char mask) {
+    int k = (int)(xorshift64(rng) % (uint64_t)__builtin_popcount(mask));
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if ((mask & (1u << d)) && k-- == 0) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+static void run_iteration(mcts_worker_t* w) {
+    const mcts_t* m = w->owner;
+    int count = m->count, horizon = MCTS_HORIZON_ROUNDS * count;
+    int x[MCTS_MAX_PLAYERS], y[MCTS_MAX_PLAYERS], gain[MCTS_MAX_PLAYERS] = {0};
+    mcts_undo_t undo[MCTS_MAX_PLIES];
+    int path[MCTS_MAX_PLIES + 1];
+    int undo_count = 0, depth = 0, path_len = 0;
+    memcpy(x, m->x, sizeof(x));
+    memcpy(y, m->y, sizeof(y));
+
+    // Seleccion y expansion: se baja por UCT hasta un nodo recien creado
+    int index = 0;
+    path[path_len++] = 0;
+    while (depth < horizon) {
+        mcts_node_t* node = &w->nodes[index];
+        if (node->first_child < 0 && ((node->visits == 0 && index != 0) || !expand(w, index, x, y))) {
+            break;
+        }
+        index = select_child(w, node);
+        path[path_len++] = index;
+        if (w->nodes[index].move != MCTS_PASS) {
+            play(w, node->mover, w->nodes[index].move, x, y, gain, &undo[undo_count++]);
+        }
+        depth++;
+        if (w->nodes[index].visits == 0) {
+            break;
+        }
+    }
+
+    // Playout aleatorio hasta el horizonte (o hasta que nadie pueda mover)
+    int passes = 0;
+    while (depth < horizon && passes < count) {
+        int mover = depth % count;
+        unsigned char mask = legal_move_mask(&w->board, x[mover], y[mover]);
+        if (mask) {
+            play(w, mover, random_move(&w->rng, mask), x, y, gain, &undo[undo_count++]);
+            passes = 0;
+        } else {
+            passes++;
+        }
+        depth++;
+    }
+
+    // Retropropagacion: cada nodo suma la recompensa de quien jugo el movimiento que lleva a el
+    double scale = 1.0 / ((double)MAX_CELL_VALUE * MCTS_HORIZON_ROUNDS);
+    w->nodes[0].visits++;
+    for (int k = 1; k < path_len; k++) {
+        mcts_node_t* node = &w->nodes[path[k]];
+        node->visits++;
+        node->reward += gain[w->nodes[path[k - 1]].mover] * scale;
+    }
+
+    while (undo_count > 0) {
+        const mcts_undo_t* u = &undo[--undo_count];
+        board_set_cell(&w->board, u->x, u->y, u->value);
+    }
+}
+
+// Pone la copia del hilo al dia con el tablero del jugador: solo las celdas que cambiaron
+// desde la busqueda anterior, salvo el primer turno o si se acumularon demasiadas
+static void sync_board(mcts_worker_t* w) {
+    const mcts_t* m = w->owner;
+    const board_t* board = m->source;
+    if (m->pending_full) {
+        memcpy(w->board.cells, board->cells, board_bytes(board->height, board->stride, board->cell_bytes));
+        if (board->free_bits) {
+            memcpy(w->board.free_bits, board->free_bits, plane_copy_bytes(board));
+        } else {
+            free_plane_build(&w->board);
+        }
+        return;
+    }
+    for (size_t k = 0; k < m->pending_count; k++) {
+        int x = (int)(m->pending[k] % (unsigned int)board->width), y = (int)(m->pending[k] / (unsigned int)board->width);
+        board_set_cell(&w->board, x, y, board_cell(board, x, y));
+    }
+}
+
+static void search_round(mcts_worker_t* w) {
+    const mcts_t* m = w->owner;
+    sync_board(w);
+    w->node_count = 1;
+    init_node(&w->nodes[0], MCTS_PASS, 0);
+    memset(w->root_visits, 0, sizeof(w->root_visits));
+    w->iterations = 0;
+    // Un hilo que arranca tarde (mas hilos que cores) solo sincroniza: no estira el movimiento.
+    // Con el arbol lleno se siguen sumando playouts desde sus hojas
+    while (monotonic_ns() < m->deadline_ns) {
+        for (int i = 0; i < MCTS_CLOCK_CHECK_ITERATIONS; i++) {
+            run_iteration(w);
+        }
+        w->iterations += MCTS_CLOCK_CHECK_ITERATIONS;
+    }
+
+    const mcts_node_t* root = &w->nodes[0];
+    for (int c = root->first_child; c >= 0 && c < root->first_child + root->child_count; c++) {
+        if (w->nodes[c].move != MCTS_PASS) {
+            w->root_visits[w->nodes[c].move] = w->nodes[c].visits;
+        }
+    }
+}
+
+static void* worker_main(void* arg) {
+    mcts_worker_t* w = arg;
+    mcts_t* m = w->owner;
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&m->lock);
+        while (m->round == seen && !m->stop) {
+            pthread_cond_wait(&m->start, &m->lock);
+        }
+        bool stop = m->stop;
+        seen = m->round;
+        pthread_mutex_unlock(&m->lock);
+        if (stop) {
+            return NULL;
+        }
+        search_round(w);
+        pthread_mutex_lock(&m->lock);
+        if (--m->running == 0) {
+            pthread_cond_signal(&m->done);
+        }
+        pthread_mutex_unlock(&m->lock);
+    }
+}
+
+signed char mcts_move(mcts_t* mcts, const board_t* board, const player_t* players, unsigned int player_count, int me, uint64_t deadline_ns) {
+    mcts->id[0] = me;
+    mcts->count = 1 + select_opponents(players, player_count, me, &mcts->id[1]);
+    for (int i = 0; i < mcts->count; i++) {
+        mcts->x[i] = players[mcts->id[i]].x;
+        mcts->y[i] = players[mcts->id[i]].y;
+    }
+    unsigned char mask = legal_move_mask(board, mcts->x[0], mcts->y[0]);
+    if (!mask) {
+        return -1;
+    }
+    if (__builtin_popcount(mask) == 1) {
+        return (signed char)__builtin_ctz(mask);
+    }
+    mcts->deadline_ns = deadline_ns;
+    mcts->source = board;
+
+    // Cada hilo se pone al dia por su cuenta y en paralelo, y el principal hace de worker 0
+    pthread_mutex_lock(&mcts->lock);
+    mcts->running = 0;
+    for (int t = 1; t < mcts->threads; t++) {
+        if (mcts->workers[t].started) mcts->running++;
+    }
+    mcts->round++;
+    pthread_cond_broadcast(&mcts->start);
+    pthread_mutex_unlock(&mcts->lock);
+    search_round(&mcts->workers[0]);
+    pthread_mutex_lock(&mcts->lock);
+    while (mcts->running > 0) {
+        pthread_cond_wait(&mcts->done, &mcts->lock);
+    }
+    pthread_mutex_unlock(&mcts->lock);
+    mcts->pending_count = 0;
+    mcts->pending_full = false;
+
+    unsigned long visits[NUM_DIRECTIONS] = {0};
+    for (int t = 0; t < mcts->threads; t++) {
+        if (!mcts->workers[t].started) continue;
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            visits[d] += mcts->workers[t].root_visits[d];
+        }
+    }
+
+    int best = -1;
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if ((mask & (1u << d)) && (best < 0 || visits[d] > visits[best])) {
+            best = d;
+        }
+    }
+    return (signed char)best;
+}
@@ -0,0 +1,143 @@
+#define _GNU_SOURCE // syscall(SYS_futex)
+#include "../include/move_channel.h"
+#include "../include/ipc.h"
+#include <linux/futex.h>
+#include <sched.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Futex compartidos entre procesos (sin FUTEX_PRIVATE_FLAG): el segmento esta mapeado en varios
+static void futex_wait(uint32_t* word, uint32_t expected, const struct timespec* timeout) {
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+bool transport_is_shm(void) {
+    const char* transport = getenv(TRANSPORT_ENV);
+    return transport && strcmp(transport, TRANSPORT_SHM) == 0;
+}
+
+size_t move_channels_size(int player_count) {
+    return sizeof(move_channels_t) + (size_t)player_count * sizeof(move_channel_t);
+}
+
+void move_channels_init(move_channels_t* channels, int player_count) {
+    memset(channels, 0, move_channels_size(player_count));
+    channels->player_count = (uint32_t)player_count;
+    channels->spin_iterations = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? MOVE_CHANNEL_SPIN_ITERATIONS : 0;
+    for (int i = 0; i < player_count; i++) {
+        channels->channels[i].turn = 1; // Como player_turn: el primer turno ya esta otorgado
+    }
+}
+
+// Quien se va a dormir anuncia waiting y vuelve a mirar la palabra; quien publica escribe la palabra
+// y despues mira waiting. Con ambos pasos seq_cst alguno de los dos ve al otro: no se pierden avisos.
+static void publish_and_wake(uint32_t* word, uint32_t* waiting) {
+    __atomic_fetch_add(word, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST)) {
+        futex_wake(word);
+    }
+}
+
+// Espera a que word deje de valer seen: primero activa, despues en el futex. false si vencio timeout.
+static bool wait_change(uint32_t* word, uint32_t* waiting, uint32_t seen, uint32_t spins, const struct timespec* timeout) {
+    for (uint32_t i = 0; i < spins; i++) {
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != seen) return true;
+        cpu_relax();
+    }
+    __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(word, __ATOMIC_SEQ_CST) == seen) {
+        futex_wait(word, seen, timeout);
+    }
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+    return __atomic_load_n(word, __ATOMIC_ACQUIRE) != seen;
+}
+
+void move_channel_post_turn(move_channels_t* channels, int id) {
+    move_channel_t* channel = &channels->channels[id];
+    publish_and_wake(&channel->turn, &channel->player_waiting);
+}
+
+bool move_channel_pop(move_channels_t* channels, int id, unsigned char* move) {
+    move_channel_t* channel = &channels->channels[id];
+    uint32_t tail = channel->tail;
+    if (__atomic_load_n(&channel->head, __ATOMIC_ACQUIRE) == tail) {
+        return false;
+    }
+    *move = channel->ring[tail & (MOVE_RING_SIZE - 1)];
+    __atomic_store_n(&channel->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool move_channel_pending(const move_channels_t* channels, int id) {
+    const move_channel_t* channel = &channels->channels[id];
+    return __atomic_load_n(&channel->head, __ATOMIC_ACQUIRE) != channel->tail ||
+           !__atomic_load_n(&channel->alive, __ATOMIC_ACQUIRE); // Terminar tambien es una novedad (EOF)
+}
+
+bool move_channels_wait(move_channels_t* channels, uint32_t seen, uint64_t timeout_ns) {
+    struct timespec timeout = { .tv_sec = (time_t)(timeout_ns / NS_PER_SEC), .tv_nsec = (long)(timeout_ns % NS_PER_SEC) };
+    return wait_change(&channels->posted, &channels->master_waiting, seen, channels->spin_iterations, &timeout);
+}
+
+void move_channel_mark_dead(move_channels_t* channels, int id) {
+    __atomic_store_n(&channels->channels[id].alive, 0, __ATOMIC_RELEASE);
+}
+
+move_channels_t* move_channels_connect(void) {
+    if (!transport_is_shm()) {
+        return NULL;
+    }
+    int fd = connect_to_shared_memory(GAME_MOVES_SHM, false);
+    if (fd < 0) {
+        return NULL;
+    }
+    move_channels_t* header = attach_shared_memory(fd, sizeof(move_channels_t), false);
+    if (!header) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = move_channels_size((int)header->player_count);
+    detach_shared_memory(header, sizeof(move_channels_t));
+    move_channels_t* channels = attach_shared_memory(fd, size, false);
+    close(fd);
+    return channels;
+}
+
+void move_channel_wait_turn(move_channels_t* channels, int id, uint32_t* turns) {
+    move_channel_t* channel = &channels->channels[id];
+    while (!wait_change(&channel->turn, &channel->player_waiting, *turns, channels->spin_iterations, NULL)) {
+        // Sin tiempo limite: solo vuelve sin turno si una señal interrumpio el futex
+    }
+    (*turns)++;
+}
+
+void move_channel_push(move_channels_t* channels, int id, unsigned char move) {
+    move_channel_t* channel = &channels->channels[id];
+    uint32_t head = channel->head;
+    while (head - __atomic_load_n(&channel->tail, __ATOMIC_ACQUIRE) == MOVE_RING_SIZE) {
+        sched_yield(); // Lleno: no pasa si se espera el turno antes de cada movimiento
+    }
+    channel->ring[head & (MOVE_RING_SIZE - 1)] = move;
+    __atomic_store_n(&channel->head, head + 1, __ATOMIC_RELEASE);
+    publish_and_wake(&channels->posted, &channels->master_waiting);
+}
+
+void move_channel_close(move_channels_t* channels, int id) {
+    __atomic_store_n(&channels->channels[id].alive, 0, __ATOMIC_RELEASE);
+    publish_and_wake(&channels->posted, &channels->master_waiting);
+}
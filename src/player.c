@@ -2,11 +2,29 @@
 #include "../include/structs.h"
 #include "../include/game_functions.h"
 #include "../include/ipc.h"
+#include "../include/snapshot.h"
+#include "../include/bitboard.h"
+#include "../include/search.h"
+#include "../include/mcts.h"
+#include "../include/territory.h"
+#include "../include/endgame.h"
+#include "../include/ttable.h"
+#include "../include/greedy.h"
+#include "../include/timing.h"
+#include "../include/move_channel.h"
 #include <semaphore.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <time.h>
+#include <string.h>
+
+typedef enum {
+    ENGINE_GREEDY, // Un movimiento: recompensa, centro y movilidad
+    ENGINE_TERRITORY, // Greedy mas el territorio (Voronoi) que gana cada candidato
+    ENGINE_SEARCH, // Busqueda paranoica con profundizacion iterativa (search.c)
+    ENGINE_MCTS    // Monte Carlo con un arbol por hilo (mcts.c)
+} engine_t;
 
 static game_state_t* game_state = NULL;
 static game_sync_t* game_sync = NULL;
@@ -23,82 +41,46 @@ static void find_my_id() {
     return;
 }
 
-void reader_enter() {
-    sem_wait(&game_sync->writer_mutex);
-    sem_wait(&game_sync->reader_count_mutex);
-    
-    game_sync->readers_count++;
-    if (game_sync->readers_count == 1) {
-        sem_wait(&game_sync->state_mutex);
-    }
-    
-    sem_post(&game_sync->reader_count_mutex);
-    sem_post(&game_sync->writer_mutex);
-}
-
-void reader_exit() {
-    sem_wait(&game_sync->reader_count_mutex);
-    
-    game_sync->readers_count--;
-    if (game_sync->readers_count == 0) {
-        sem_post(&game_sync->state_mutex);
-    }
-    
-    sem_post(&game_sync->reader_count_mutex);
-}
-
-int evaluate_cell(int* board, int x, int y, int width, int height) {
-    if (!is_valid_position(x, y, width, height)) {
-        return INVALID_POSITION_SCORE; // Posición inválida
-    }
-     
-    if (!is_cell_free(board, x, y, width, height)) {
-        return OCCUPIED_CELL_SCORE; // Celda ocupada
-    }
-    
-    int reward = get_cell_value(board, x, y, width, height);
-    int score = reward * BASE_REWARD_MULTIPLIER; // Valor base de la recompensa
-    
-    // Bonificar celdas que nos acercan al centro (más opciones futuras)
-    int center_x = game_state->width / 2;
-    int center_y = game_state->height / 2;
-    int distance_to_center = abs(x - center_x) + abs(y - center_y);
-    score += (CENTER_BONUS_MAX - distance_to_center); // Bonificar cercanía al centro
-    
-    // Contar celdas libres adyacentes (movilidad futura)
-    int free_neighbors = 0;
-    for (int dir = 0; dir < NUM_DIRECTIONS; dir++) {
-        int nx = x + MOVE_DELTAS[dir][0];
-        int ny = y + MOVE_DELTAS[dir][1];
-        if (is_cell_free(board, nx, ny, width, height)) {
-            free_neighbors++;
-        }
-    }
-    return score + free_neighbors * MOBILITY_BONUS;
-}
-
-static signed char calculate_move(int* board,int x, int y, bool blocked, int width, int height) {
-    int best = -1, best_score = -1;
-
-    for (unsigned char d = 0; d < NUM_DIRECTIONS; d++) {
-        if (is_valid_move(board, d, x, y, blocked, width,  height)) {
-            int nx = x + MOVE_DELTAS[(int)d][0];
-            int ny = y + MOVE_DELTAS[(int)d][1];
-            int s = evaluate_cell(board, nx, ny, width, height);
-            if (s > best_score) { best_score = s; best = d; }
-        }
-    }
-    return (signed char)best;  // -1 si no encontro
-}
-
-
 int main(int argc, char * argv[]){
-    if(argc != 3){
-        fprintf(stderr, "Uso: %s <width> <height>\n", argv[0]);
+    if(argc < 3){
+        fprintf(stderr, "Uso: %s <width> <height> [-e greedy|territory|search|mcts] [-m ms_por_movimiento] [-j hilos] [-t MB_tabla]\n", argv[0]);
         return EXIT_FAILURE;
     }
     int width = atoi(argv[1]);
     int height = atoi(argv[2]);
+    engine_t engine = ENGINE_GREEDY;
+    long budget_ms = SEARCH_DEFAULT_BUDGET_MS;
+    long threads = mcts_default_threads(); // MCTS: por defecto un hilo por core permitido
+    long table_mb = TT_DEFAULT_MEGABYTES; // Busqueda: tope de la tabla de transposicion
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "search") == 0) {
+                engine = ENGINE_SEARCH;
+            } else if (strcmp(argv[i], "mcts") == 0) {
+                engine = ENGINE_MCTS;
+            } else if (strcmp(argv[i], "territory") == 0) {
+                engine = ENGINE_TERRITORY;
+            } else if (strcmp(argv[i], "greedy") == 0) {
+                engine = ENGINE_GREEDY;
+            } else {
+                fprintf(stderr, "Motor desconocido: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            budget_ms = atol(argv[++i]);
+            if (budget_ms < 1) budget_ms = 1;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            table_mb = atol(argv[++i]);
+            if (table_mb < 0) table_mb = 0;
+            if (table_mb > TT_MAX_MEGABYTES) table_mb = TT_MAX_MEGABYTES;
+        } else {
+            fprintf(stderr, "Uso: %s <width> <height> [-e greedy|territory|search|mcts] [-m ms_por_movimiento] [-j hilos] [-t MB_tabla]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
 
     game_state = setup_game_state(width,height);
     game_sync = setup_game_sync();
@@ -111,33 +93,115 @@ int main(int argc, char * argv[]){
     if(id==-1){ 
         return EXIT_FAILURE;
     }
+    // Con --transport shm el turno y el movimiento van por el anillo propio en vez de semaforo y pipe
+    move_channels_t* channels = move_channels_connect();
+    if (transport_is_shm() && !channels) {
+        fprintf(stderr, "Error al conectarse a los canales de movimientos\n");
+        return EXIT_FAILURE;
+    }
+    uint32_t turns = 0;
 
+    state_snapshot_t snapshot;
+    if (snapshot_init(&snapshot, game_state) != 0) {
+        fprintf(stderr, "Error al reservar la copia local del tablero\n");
+        return EXIT_FAILURE;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_MCTS_THREADS) threads = MAX_MCTS_THREADS;
+    mcts_t mcts = {0};
+    if (engine == ENGINE_MCTS && mcts_init(&mcts, &snapshot.board, (int)threads) != 0) {
+        fprintf(stderr, "Error al reservar los arboles de MCTS\n");
+        snapshot_free(&snapshot);
+        return EXIT_FAILURE;
+    }
+    territory_t territory = {0};
+    if (engine == ENGINE_TERRITORY && territory_init(&territory, width, height) != 0) {
+        fprintf(stderr, "Error al reservar los arreglos de territorio\n");
+        mcts_free(&mcts);
+        snapshot_free(&snapshot);
+        return EXIT_FAILURE;
+    }
+    ttable_t table = {0};
+    if (engine == ENGINE_SEARCH && ttable_init(&table, (size_t)table_mb) != 0) {
+        fprintf(stderr, "Error al reservar la tabla de transposicion\n");
+        territory_free(&territory);
+        mcts_free(&mcts);
+        snapshot_free(&snapshot);
+        return EXIT_FAILURE;
+    }
+    endgame_t endgame;
+    if (endgame_init(&endgame, width, height) != 0) {
+        fprintf(stderr, "Error al reservar el plan de final\n");
+        ttable_free(&table);
+        territory_free(&territory);
+        mcts_free(&mcts);
+        snapshot_free(&snapshot);
+        return EXIT_FAILURE;
+    }
+    uint64_t board_hash = 0; // Zobrist del tablero local, al dia con los deltas
     bool game_over = false;
-    int copy[width*height];
-    int copy_x, copy_y, copy_blocked;
     
     do{
-        sem_wait(&game_sync->player_turn[id]); //post lo hace master (es su responsabilidad asignar turnos)
-        reader_enter();
-        game_over = game_state->is_game_over;
+        if (channels) {
+            move_channel_wait_turn(channels, id, &turns);
+        } else {
+            sem_wait(&game_sync->player_turn[id]); //post lo hace master (es su responsabilidad asignar turnos)
+        }
+        uint64_t deadline_ns = monotonic_ns() + (uint64_t)budget_ms * MS_TO_NS;
+        // Solo se aplican los movimientos publicados desde el turno anterior
+        snapshot_update(&snapshot, game_state);
+        game_over = snapshot.is_game_over;
 
         if(game_over){ 
-            reader_exit();
             break;
         }
-        for(int i = 0; i < width*height; i++){
-            copy[i] = game_state->board[i];
-        }
-        copy_x = game_state->players[id].x;
-        copy_y = game_state->players[id].y;
-        copy_blocked = game_state->players[id].blocked;
-        reader_exit();
 
-        signed char move = calculate_move(copy, copy_x, copy_y, copy_blocked, width, height);
+        const player_t* me = &snapshot.players[id];
+        if (engine == ENGINE_SEARCH) {
+            if (snapshot.full_copy) {
+                board_hash = zobrist_board(&snapshot.board);
+            } else {
+                for (size_t k = 0; k < snapshot.changed_count; k++) {
+                    unsigned int cell = snapshot.changed[k];
+                    int owner = -board_cell(&snapshot.board, (int)(cell % (unsigned int)width), (int)(cell / (unsigned int)width));
+                    board_hash ^= zobrist_cell(cell, (unsigned int)owner);
+                }
+            }
+            ttable_new_turn(&table);
+        } else if (engine == ENGINE_MCTS) {
+            mcts_observe(&mcts, snapshot.changed, snapshot.changed_count, snapshot.full_copy);
+        }
+        signed char move;
+        if (me->blocked) {
+            move = -1;
+        } else if (endgame_move(&endgame, &snapshot.board, snapshot.players, snapshot.player_count, id, deadline_ns, &move)) {
+            // Aislado de los rivales: se juega el plan del final, con cualquier motor
+        } else if (engine == ENGINE_SEARCH) {
+            move = search_move(&snapshot.board, snapshot.players, snapshot.player_count, id, deadline_ns, table.buckets ? &table : NULL, board_hash);
+        } else if (engine == ENGINE_MCTS) {
+            move = mcts_move(&mcts, &snapshot.board, snapshot.players, snapshot.player_count, id, deadline_ns);
+        } else {
+            territory_t* evaluator = NULL;
+            if (engine == ENGINE_TERRITORY) {
+                territory_prepare(&territory, &snapshot.board, snapshot.players, snapshot.player_count, id);
+                evaluator = &territory;
+            }
+            move = calculate_move(&snapshot.board, me->x, me->y, false, evaluator);
+        }
         if(move == -1){
             break;
         }
-        write(STDOUT_FILENO, &move, MOVE_DATA_SIZE);
+        if (channels) {
+            move_channel_push(channels, id, (unsigned char)move);
+        } else {
+            write(STDOUT_FILENO, &move, MOVE_DATA_SIZE);
+        }
     }while(!game_over);
+    if (channels) move_channel_close(channels, id); // Equivale al EOF del pipe
+    endgame_free(&endgame);
+    ttable_free(&table);
+    territory_free(&territory);
+    mcts_free(&mcts);
+    snapshot_free(&snapshot);
     return 0;
 }
@@ -0,0 +1,376 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/structs.h"
+#include "../include/game_functions.h"
+#include "../include/ipc.h"
+#include "../include/replay_log.h"
+#include "../include/replay_engine.h"
+#include "../include/timing.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SEEKS 64
+#define VIEW_POLL_MS 10
+
+typedef struct {
+    const char* path;
+    size_t interval;
+    size_t seeks[MAX_SEEKS];
+    int seek_count;
+    const char* view_path;
+    double speed; // 0: sin esperas, lo mas rapido que dibuje la vista
+    int fps;
+    size_t from;
+    size_t to;
+    bool verify;
+    long threads;
+    char** files; // --verify: archivos a reproducir
+    int file_count;
+} replay_config_t;
+
+// Un resultado por archivo de --verify, lo completa el hilo que lo tomo
+typedef struct {
+    bool ok;
+    size_t records;
+    size_t mismatches;
+    bool complete; // Tenia cierre
+} verify_result_t;
+
+typedef struct {
+    const replay_config_t* config;
+    verify_result_t* results;
+    int next; // Proximo archivo sin tomar (atomico)
+} verify_queue_t;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void signal_handler(int sig __attribute__((unused))) {
+    interrupted = 1;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Uso: %s <replay> [-n movimiento]... [-k intervalo]\n"
+            "       %s <replay> -v <vista> [--speed x] [--fps n] [--from mov] [--to mov]\n"
+            "       %s --verify [-j hilos] <replay>...\n", prog, prog, prog);
+}
+
+static void parser(replay_config_t* config, int argc, char* argv[]) {
+    memset(config, 0, sizeof(*config));
+    config->interval = REPLAY_KEYFRAME_INTERVAL;
+    config->speed = 1.0;
+    config->fps = VIEW_DEFAULT_FPS;
+    config->to = (size_t)-1;
+    config->threads = sysconf(_SC_NPROCESSORS_ONLN);
+    config->files = calloc((size_t)argc, sizeof(char*));
+    if (!config->files) {
+        perror("Error al reservar memoria");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            if (config->seek_count == MAX_SEEKS) {
+                fprintf(stderr, "Error: Se admiten como maximo %d saltos (-n)\n", MAX_SEEKS);
+                exit(EXIT_FAILURE);
+            }
+            config->seeks[config->seek_count++] = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            config->interval = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+            config->view_path = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            config->speed = atof(argv[++i]);
+            if (config->speed < 0) config->speed = 0;
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            config->fps = atoi(argv[++i]);
+            if (config->fps < 1) config->fps = 1;
+            if (config->fps > VIEW_MAX_FPS) config->fps = VIEW_MAX_FPS;
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            config->from = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            config->to = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            config->verify = true;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            config->threads = atol(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        } else {
+            config->files[config->file_count++] = argv[i];
+        }
+    }
+    if (config->threads < 1) config->threads = 1;
+    if (config->file_count == 0 || (!config->verify && config->file_count != 1)) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    config->path = config->files[0];
+    if (config->view_path && !is_executable_file(config->view_path)) {
+        fprintf(stderr, "Error: %s no es ejecutable\n", config->view_path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// game_state local: la misma disposicion que el segmento compartido, sin nadie mas que lo lea
+static game_state_t* allocate_local_state(const replay_header_t* header) {
+    size_t size = game_state_size(header->width, header->height, header->player_count, header->cell_bytes);
+    void* memory = NULL;
+    if (posix_memalign(&memory, SHM_ALIGNMENT, size) != 0) {
+        return NULL;
+    }
+    memset(memory, 0, size);
+    return memory;
+}
+
+static void print_players(const game_state_t* state, size_t position) {
+    printf("Movimiento %zu:\n", position);
+    for (unsigned int i = 0; i < state->player_count; i++) {
+        const player_t* p = &state->players[i];
+        printf("  %-*s (%hu, %hu) puntaje %u validos %u invalidos %u%s\n", MAX_NAME_LENGTH, p->name,
+               p->x, p->y, p->score, p->valid_moves, p->invalid_moves, p->blocked ? " bloqueado" : "");
+    }
+}
+
+// Sin -v: reproduce todo (y cada -n pedido) sobre memoria local y compara con el cierre
+static int replay_summary(const replay_config_t* config, const replay_file_t* file) {
+    game_state_t* state = allocate_local_state(&file->header);
+    if (!state) {
+        fprintf(stderr, "Error al reservar el estado del replay\n");
+        return EXIT_FAILURE;
+    }
+    replay_engine_t engine;
+    if (replay_engine_init(&engine, file, state, config->interval) != 0) {
+        fprintf(stderr, "Error al reservar los keyframes\n");
+        free(state);
+        return EXIT_FAILURE;
+    }
+    uint64_t start_ns = monotonic_ns();
+    replay_engine_seek(&engine, file->record_count);
+    uint64_t elapsed_ns = monotonic_ns() - start_ns;
+    bool matches = replay_engine_matches(&engine);
+
+    int winner = determine_winner(state);
+    for (unsigned int i = 0; i < state->player_count; i++) {
+        const player_t* p = &state->players[i];
+        printf("%s,%u,%u,%u,%u,%d\n", SUMMARY_PREFIX, i, p->score, p->valid_moves, p->invalid_moves, (int)i == winner);
+    }
+    printf("Replay: %zu movimientos en %.3f ms (%.1f M mov/s), %zu keyframes cada %zu, %s\n",
+           file->record_count, (double)elapsed_ns / MS_TO_NS,
+           elapsed_ns ? (double)file->record_count * 1e3 / (double)elapsed_ns : 0.0,
+           engine.keyframe_count, engine.interval,
+           !file->results ? (matches ? "sin cierre (validez coincide)" : "sin cierre, NO coincide")
+                          : (matches ? "coincide con el cierre" : "NO coincide con el cierre"));
+
+    for (int k = 0; k < config->seek_count; k++) {
+        start_ns = monotonic_ns();
+        replay_engine_seek(&engine, config->seeks[k]);
+        elapsed_ns = monotonic_ns() - start_ns;
+        print_players(state, engine.position);
+        printf("  (salto en %.3f ms)\n", (double)elapsed_ns / MS_TO_NS);
+    }
+    replay_engine_free(&engine);
+    free(state);
+    return matches ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static pid_t create_view_process(const char* view_path, const replay_header_t* header, int fps) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Error al crear proceso");
+        return ERR_FORK;
+    } else if (pid == 0) {
+        char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE], fps_str[ARG_BUFFER_SIZE];
+        snprintf(width_str, sizeof(width_str), "%hu", header->width);
+        snprintf(height_str, sizeof(height_str), "%hu", header->height);
+        snprintf(fps_str, sizeof(fps_str), "%d", fps);
+        execl(view_path, view_path, width_str, height_str, "--fps", fps_str, NULL);
+        perror("Error haciendo el execl");
+        exit(EXIT_FAILURE);
+    }
+    return pid;
+}
+
+static void sleep_until_ns(uint64_t target_ns) {
+    struct timespec until = { .tv_sec = (time_t)(target_ns / NS_PER_SEC), .tv_nsec = (long)(target_ns % NS_PER_SEC) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR && !interrupted) {
+    }
+}
+
+// Con -v: el estado vive en /game_state y la vista lo dibuja como espectador (--fps), igual que
+// en una partida con --spectate; cada registro aplicado es un cuadro nuevo
+static int replay_view(const replay_config_t* config, const replay_file_t* file) {
+    const replay_header_t* header = &file->header;
+    const char* game_id = getenv(GAME_ID_ENV);
+    char pid_id[GAME_ID_MAX_LENGTH + 1];
+    if (!game_id || game_id[0] == '\0') { // Sin pisar una partida en curso con los nombres por defecto
+        snprintf(pid_id, sizeof(pid_id), "replay%ld", (long)getpid());
+        setenv(GAME_ID_ENV, pid_id, 1);
+    } else if (!is_valid_game_id(game_id)) {
+        fprintf(stderr, "Error: %s invalido\n", GAME_ID_ENV);
+        return EXIT_FAILURE;
+    }
+    size_t size = game_state_size(header->width, header->height, header->player_count, header->cell_bytes);
+    int fd = create_shared_memory(GAME_STATE_SHM, size);
+    if (fd < 0) {
+        return EXIT_FAILURE;
+    }
+    game_state_t* state = attach_shared_memory(fd, size, false);
+    int exit_code = EXIT_FAILURE;
+    replay_engine_t engine = {0};
+    pid_t view_pid = -1;
+    int status;
+    if (!state) {
+        goto clear;
+    }
+    if (replay_engine_init(&engine, file, state, config->interval) != 0) {
+        fprintf(stderr, "Error al reservar los keyframes\n");
+        goto clear;
+    }
+    size_t to = config->to < file->record_count ? config->to : file->record_count;
+    size_t from = config->from < to ? config->from : to;
+    state_write_begin(state);
+    replay_engine_seek(&engine, from);
+    state_write_end(state);
+
+    view_pid = create_view_process(config->view_path, header, config->fps);
+    if (view_pid < 0) {
+        goto clear;
+    }
+
+    uint64_t base_ns = from < file->record_count ? file->records[from].time_ns : 0;
+    uint64_t start_ns = monotonic_ns();
+    while (!interrupted && engine.position < to) {
+        if (config->speed > 0) {
+            uint64_t offset_ns = file->records[engine.position].time_ns - base_ns;
+            sleep_until_ns(start_ns + (uint64_t)((double)offset_ns / config->speed));
+        }
+        state_write_begin(state);
+        replay_engine_step(&engine);
+        state_write_end(state);
+    }
+    state_write_begin(state);
+    state->is_game_over = true; // La vista muestra el cartel y termina sola
+    state_write_end(state);
+    exit_code = EXIT_SUCCESS;
+
+    struct timespec poll_ts = { .tv_sec = 0, .tv_nsec = VIEW_POLL_MS * MS_TO_NS };
+    uint64_t deadline_ns = monotonic_ns() + (uint64_t)FINAL_VIEW_DISPLAY_MS * MS_TO_NS;
+    while (!interrupted && monotonic_ns() < deadline_ns && waitpid(view_pid, &status, WNOHANG) == 0) {
+        nanosleep(&poll_ts, NULL);
+    }
+
+clear:
+    if (view_pid > 0 && waitpid(view_pid, &status, WNOHANG) == 0) {
+        kill(view_pid, SIGTERM);
+        waitpid(view_pid, &status, 0);
+    }
+    replay_engine_free(&engine);
+    if (state) {
+        detach_shared_memory(state, size);
+    }
+    close(fd);
+    clear_shm(GAME_STATE_SHM);
+    return exit_code;
+}
+
+static void* verify_worker(void* arg) {
+    verify_queue_t* queue = arg;
+    for (;;) {
+        int index = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED);
+        if (index >= queue->config->file_count || interrupted) {
+            return NULL;
+        }
+        verify_result_t* result = &queue->results[index];
+        replay_file_t file;
+        if (replay_file_open(&file, queue->config->files[index]) != 0) {
+            continue; // result->ok queda en false
+        }
+        game_state_t* state = allocate_local_state(&file.header);
+        replay_engine_t engine;
+        if (state && replay_engine_init(&engine, &file, state, 0) == 0) { // Sin saltos: solo hace falta avanzar
+            while (replay_engine_step(&engine)) {
+            }
+            result->ok = replay_engine_matches(&engine);
+            result->records = file.record_count;
+            result->mismatches = engine.mismatches;
+            result->complete = file.results != NULL;
+            replay_engine_free(&engine);
+        }
+        free(state);
+        replay_file_close(&file);
+    }
+}
+
+// --verify: reparte los archivos entre hilos; cada uno reproduce sobre su propia memoria local
+static int replay_verify(const replay_config_t* config) {
+    verify_queue_t queue = { .config = config, .next = 0 };
+    queue.results = calloc((size_t)config->file_count, sizeof(verify_result_t));
+    long thread_count = config->threads < config->file_count ? config->threads : config->file_count;
+    pthread_t* threads = calloc((size_t)thread_count, sizeof(pthread_t));
+    if (!queue.results || !threads) {
+        perror("Error al reservar memoria");
+        free(queue.results);
+        free(threads);
+        return EXIT_FAILURE;
+    }
+    uint64_t start_ns = monotonic_ns();
+    long started = 0;
+    while (started < thread_count && pthread_create(&threads[started], NULL, verify_worker, &queue) == 0) {
+        started++;
+    }
+    if (started == 0) {
+        verify_worker(&queue); // Sin hilos: se verifica todo en este
+    }
+    for (long t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    uint64_t elapsed_ns = monotonic_ns() - start_ns;
+
+    int failed = 0;
+    size_t records = 0;
+    for (int i = 0; i < config->file_count; i++) {
+        const verify_result_t* result = &queue.results[i];
+        records += result->records;
+        if (!result->ok) {
+            failed++;
+            printf("%s: NO coincide (%zu registros, %zu con otra validez%s)\n", config->files[i],
+                   result->records, result->mismatches, result->complete ? "" : ", sin cierre");
+        }
+    }
+    printf("Verificados %d replays con %ld hilos: %d coinciden, %d no, %zu movimientos en %.3f s (%.1f M mov/s)\n",
+           config->file_count, started ? started : 1, config->file_count - failed, failed, records,
+           (double)elapsed_ns / NS_PER_SEC, elapsed_ns ? (double)records * 1e3 / (double)elapsed_ns : 0.0);
+    free(threads);
+    free(queue.results);
+    return failed == 0 && !interrupted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGHUP, signal_handler);
+
+    replay_config_t config;
+    parser(&config, argc, argv);
+    int exit_code;
+    if (config.verify) {
+        exit_code = replay_verify(&config);
+    } else {
+        replay_file_t file;
+        if (replay_file_open(&file, config.path) != 0) {
+            free(config.files);
+            return EXIT_FAILURE;
+        }
+        exit_code = config.view_path ? replay_view(&config, &file) : replay_summary(&config, &file);
+        replay_file_close(&file);
+    }
+    free(config.files);
+    return exit_code;
+}
@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/replay_engine.h"
+#include "../include/game_functions.h"
+#include "../include/ipc.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Guarda el estado actual como keyframe position / interval. Si los keyframes pasan el tope de
+// memoria se descartan los impares y se duplica el intervalo (el costo de un salto se duplica,
+// la memoria queda acotada).
+static void store_keyframe(replay_engine_t* engine) {
+    size_t index = engine->interval ? engine->position / engine->interval : 0;
+    if (index != engine->keyframe_count) {
+        return;
+    }
+    size_t limit = (size_t)REPLAY_KEYFRAME_MAX_MB * 1024 * 1024 / engine->keyframe_bytes;
+    if (engine->keyframe_count >= 2 && engine->keyframe_count + 1 > limit) {
+        for (size_t k = 1; 2 * k < engine->keyframe_count; k++) {
+            memcpy(engine->keyframes + k * engine->keyframe_bytes, engine->keyframes + 2 * k * engine->keyframe_bytes, engine->keyframe_bytes);
+        }
+        engine->keyframe_count = (engine->keyframe_count + 1) / 2;
+        engine->interval *= 2;
+        if (engine->position % engine->interval != 0 || engine->position / engine->interval != engine->keyframe_count) {
+            return;
+        }
+    }
+    if (engine->keyframe_count == engine->keyframe_capacity) {
+        size_t capacity = engine->keyframe_capacity ? engine->keyframe_capacity * 2 : 16;
+        unsigned char* keyframes = realloc(engine->keyframes, capacity * engine->keyframe_bytes);
+        if (!keyframes) {
+            return; // Sin memoria: los saltos recorren mas movimientos, pero siguen siendo correctos
+        }
+        engine->keyframes = keyframes;
+        engine->keyframe_capacity = capacity;
+    }
+    memcpy(engine->keyframes + engine->keyframe_count * engine->keyframe_bytes,
+           (unsigned char*)engine->state + engine->keyframe_offset, engine->keyframe_bytes);
+    engine->keyframe_count++;
+}
+
+static void restore_keyframe(replay_engine_t* engine, size_t index) {
+    memcpy((unsigned char*)engine->state + engine->keyframe_offset,
+           engine->keyframes + index * engine->keyframe_bytes, engine->keyframe_bytes);
+    engine->position = index * engine->interval;
+    // Los deltas publicados ya no describen el tablero: los lectores quedan "atras" y copian todo
+    engine->state->delta_version += (unsigned long long)engine->state->delta_capacity + 1;
+}
+
+int replay_engine_init(replay_engine_t* engine, const replay_file_t* file, game_state_t* state, size_t interval) {
+    memset(engine, 0, sizeof(*engine));
+    const replay_header_t* header = &file->header;
+    initialize_game_state(state, header->width, header->height, header->player_count, header->cell_bytes, header->seed);
+    for (unsigned int i = 0; i < header->player_count; i++) {
+        memcpy(state->players[i].name, file->names + (size_t)i * MAX_NAME_LENGTH, MAX_NAME_LENGTH);
+        state->players[i].name[MAX_NAME_LENGTH - 1] = '\0';
+    }
+    engine->file = file;
+    engine->state = state;
+    engine->interval = interval;
+    engine->keyframe_offset = offsetof(game_state_t, players);
+    engine->keyframe_bytes = state->delta_offset - engine->keyframe_offset;
+    store_keyframe(engine);
+    if (engine->keyframe_count == 0) {
+        return ERR_GENERIC; // Sin el estado inicial no se puede volver atras
+    }
+    return 0;
+}
+
+void replay_engine_free(replay_engine_t* engine) {
+    free(engine->keyframes);
+    engine->keyframes = NULL;
+    engine->keyframe_count = 0;
+    engine->keyframe_capacity = 0;
+}
+
+bool replay_engine_step(replay_engine_t* engine) {
+    if (engine->position >= engine->file->record_count) {
+        return false;
+    }
+    const replay_record_t* record = &engine->file->records[engine->position];
+    game_state_t* state = engine->state;
+    bool valid = false;
+    if (record->player < state->player_count) {
+        player_t* player = &state->players[record->player];
+        if (record->flags & (REPLAY_PLAYER_LEFT | REPLAY_DEADLINE_MISSED)) {
+            // El máster los graba sin REPLAY_MOVE_VALID y sin mirar el tablero
+            if (record->flags & REPLAY_DEADLINE_MISSED) player->invalid_moves++;
+            if (record->flags & REPLAY_PLAYER_LEFT) player->blocked = true;
+        } else {
+            // Lo mismo que el máster hace con cada movimiento leido del pipe
+            board_t board = game_board(state);
+            valid = is_valid_move(&board, record->move, player->x, player->y, player->blocked);
+            if (valid) {
+                apply_move(state, record->player, record->move);
+            } else {
+                player->invalid_moves++;
+            }
+            player->blocked = is_player_blocked(&board, player->x, player->y);
+        }
+    }
+    if (engine->position == engine->checked) {
+        if (valid != ((record->flags & REPLAY_MOVE_VALID) != 0)) {
+            engine->mismatches++;
+        }
+        engine->checked++;
+    }
+    engine->position++;
+    if (engine->interval && engine->position % engine->interval == 0) {
+        store_keyframe(engine);
+    }
+    return true;
+}
+
+void replay_engine_seek(replay_engine_t* engine, size_t position) {
+    if (position > engine->file->record_count) {
+        position = engine->file->record_count;
+    }
+    size_t index = engine->interval ? position / engine->interval : 0;
+    if (index >= engine->keyframe_count) {
+        index = engine->keyframe_count - 1;
+    }
+    size_t base = index * engine->interval;
+    // Desde la posicion actual solo si esta entre el keyframe y el destino
+    if (engine->position > position || engine->position < base) {
+        restore_keyframe(engine, index);
+    }
+    while (engine->position < position && replay_engine_step(engine)) {
+    }
+}
+
+bool replay_engine_matches(const replay_engine_t* engine) {
+    if (engine->mismatches > 0 || engine->position != engine->file->record_count) {
+        return false;
+    }
+    if (!engine->file->results) {
+        return true;
+    }
+    for (unsigned int i = 0; i < engine->state->player_count; i++) {
+        const player_t* player = &engine->state->players[i];
+        const replay_result_t* result = &engine->file->results[i];
+        if (player->score != result->score || player->valid_moves != result->valid_moves || player->invalid_moves != result->invalid_moves) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,242 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/replay_log.h"
+#include "../include/timing.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int write_all(int fd, const void* data, size_t size) {
+    const char* bytes = data;
+    while (size > 0) {
+        ssize_t n = write(fd, bytes, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return ERR_GENERIC;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+// Escribe los registros [tail, head) del anillo (a lo sumo dos tramos contiguos)
+static void drain(replay_log_t* log) {
+    size_t head = __atomic_load_n(&log->head, __ATOMIC_ACQUIRE);
+    size_t tail = log->tail;
+    while (tail != head) {
+        size_t index = tail & (REPLAY_RING_RECORDS - 1);
+        size_t count = head - tail;
+        if (count > REPLAY_RING_RECORDS - index) {
+            count = REPLAY_RING_RECORDS - index;
+        }
+        if (!__atomic_load_n(&log->failed, __ATOMIC_RELAXED) &&
+            write_all(log->fd, &log->ring[index], count * sizeof(replay_record_t)) != 0) {
+            perror("Error escribiendo el replay");
+            __atomic_store_n(&log->failed, true, __ATOMIC_RELAXED);
+        }
+        tail += count;
+        __atomic_store_n(&log->tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+static void* writer_thread(void* arg) {
+    replay_log_t* log = arg;
+    for (;;) {
+        pthread_mutex_lock(&log->mutex);
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += (long)REPLAY_FLUSH_INTERVAL_MS * MS_TO_NS;
+        if (until.tv_nsec >= NS_PER_SEC) {
+            until.tv_sec++;
+            until.tv_nsec -= NS_PER_SEC;
+        }
+        while (!log->stop && __atomic_load_n(&log->head, __ATOMIC_ACQUIRE) - log->tail < REPLAY_FLUSH_RECORDS) {
+            if (pthread_cond_timedwait(&log->wake, &log->mutex, &until) == ETIMEDOUT) {
+                break;
+            }
+        }
+        bool stop = log->stop;
+        pthread_mutex_unlock(&log->mutex);
+
+        drain(log);
+        if (stop) {
+            drain(log); // Lo encolado antes de pedir el cierre
+            return NULL;
+        }
+    }
+}
+
+int replay_log_open(replay_log_t* log, const char* path, const game_state_t* state, unsigned int seed) {
+    memset(log, 0, sizeof(*log));
+    log->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (log->fd < 0) {
+        perror("Error al crear el archivo de replay");
+        return ERR_GENERIC;
+    }
+    replay_header_t header = {0};
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_FORMAT_VERSION;
+    header.seed = seed;
+    header.width = state->width;
+    header.height = state->height;
+    header.player_count = (uint16_t)state->player_count;
+    header.cell_bytes = state->cell_bytes;
+    header.started_at = (int64_t)time(NULL);
+    int result = write_all(log->fd, &header, sizeof(header));
+    for (unsigned int i = 0; i < state->player_count && result == 0; i++) {
+        result = write_all(log->fd, state->players[i].name, MAX_NAME_LENGTH);
+    }
+    log->ring = malloc(REPLAY_RING_RECORDS * sizeof(replay_record_t));
+    if (result != 0 || !log->ring) {
+        perror("Error al preparar el replay");
+        free(log->ring);
+        close(log->fd);
+        log->ring = NULL;
+        log->fd = -1;
+        return ERR_GENERIC;
+    }
+    pthread_mutex_init(&log->mutex, NULL);
+    pthread_cond_init(&log->wake, NULL);
+    if (pthread_create(&log->thread, NULL, writer_thread, log) != 0) {
+        fprintf(stderr, "Error al crear el hilo del replay\n");
+        pthread_cond_destroy(&log->wake);
+        pthread_mutex_destroy(&log->mutex);
+        free(log->ring);
+        close(log->fd);
+        log->ring = NULL;
+        log->fd = -1;
+        return ERR_GENERIC;
+    }
+    log->started = true;
+    log->start_ns = monotonic_ns();
+    return 0;
+}
+
+void replay_log_move(replay_log_t* log, int player, unsigned char move, unsigned char flags, uint64_t now_ns) {
+    if (!log->started) {
+        return;
+    }
+    size_t head = log->head;
+    size_t tail = __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE);
+    while (head - tail == REPLAY_RING_RECORDS) { // Lleno: se espera al escritor antes de pisar nada
+        pthread_cond_signal(&log->wake);
+        struct timespec wait = { .tv_sec = 0, .tv_nsec = (long)REPLAY_FULL_WAIT_US * US_TO_NS };
+        nanosleep(&wait, NULL);
+        tail = __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE);
+    }
+    replay_record_t* record = &log->ring[head & (REPLAY_RING_RECORDS - 1)];
+    record->time_ns = now_ns - log->start_ns;
+    record->player = (uint16_t)player;
+    record->move = move;
+    record->flags = flags;
+    record->reserved = 0;
+    __atomic_store_n(&log->head, head + 1, __ATOMIC_RELEASE);
+    log->records++;
+    if (head + 1 - tail == REPLAY_FLUSH_RECORDS) {
+        pthread_cond_signal(&log->wake); // Sin tomar el mutex: si se pierde, el escritor igual vence su espera
+    }
+}
+
+int replay_log_close(replay_log_t* log, const game_state_t* state) {
+    if (!log->started) {
+        return 0;
+    }
+    pthread_mutex_lock(&log->mutex);
+    log->stop = true;
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->mutex);
+    pthread_join(log->thread, NULL);
+    log->started = false;
+
+    int result = log->failed ? ERR_GENERIC : 0;
+    for (unsigned int i = 0; i < state->player_count && result == 0; i++) {
+        replay_result_t player = { state->players[i].score, state->players[i].valid_moves, state->players[i].invalid_moves };
+        result = write_all(log->fd, &player, sizeof(player));
+    }
+    replay_footer_t footer = {0};
+    memcpy(footer.magic, REPLAY_FOOTER_MAGIC, sizeof(footer.magic));
+    footer.player_count = state->player_count;
+    footer.record_count = log->records;
+    footer.duration_ns = monotonic_ns() - log->start_ns;
+    if (result == 0) {
+        result = write_all(log->fd, &footer, sizeof(footer));
+    }
+    if (result != 0) {
+        fprintf(stderr, "Error escribiendo el replay: el archivo quedo sin cierre\n");
+    }
+    close(log->fd);
+    log->fd = -1;
+    free(log->ring);
+    log->ring = NULL;
+    pthread_cond_destroy(&log->wake);
+    pthread_mutex_destroy(&log->mutex);
+    return result;
+}
+
+int replay_file_open(replay_file_t* file, const char* path) {
+    memset(file, 0, sizeof(*file));
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(path);
+        return ERR_GENERIC;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(replay_header_t)) {
+        fprintf(stderr, "%s: no es un replay\n", path);
+        close(fd);
+        return ERR_GENERIC;
+    }
+    file->map_size = (size_t)st.st_size;
+    file->map = mmap(NULL, file->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file->map == MAP_FAILED) {
+        perror(path);
+        file->map = NULL;
+        return ERR_GENERIC;
+    }
+    const unsigned char* bytes = file->map;
+    memcpy(&file->header, bytes, sizeof(file->header));
+    const replay_header_t* header = &file->header;
+    size_t prefix = sizeof(replay_header_t) + (size_t)header->player_count * MAX_NAME_LENGTH;
+    if (memcmp(header->magic, REPLAY_MAGIC, sizeof(header->magic)) != 0 || header->version < REPLAY_MIN_FORMAT_VERSION || header->version > REPLAY_FORMAT_VERSION ||
+        header->player_count == 0 || header->player_count > MAX_PLAYERS ||
+        header->width < MIN_BOARD_SIZE || header->height < MIN_BOARD_SIZE ||
+        (header->cell_bytes != sizeof(int) && header->cell_bytes != COMPACT_CELL_BYTES) || file->map_size < prefix) {
+        fprintf(stderr, "%s: encabezado de replay invalido\n", path);
+        replay_file_close(file);
+        return ERR_GENERIC;
+    }
+    file->names = (const char*)(bytes + sizeof(replay_header_t));
+    file->records = (const replay_record_t*)(bytes + prefix);
+
+    size_t closing = (size_t)header->player_count * sizeof(replay_result_t) + sizeof(replay_footer_t);
+    if (file->map_size >= prefix + closing) {
+        memcpy(&file->footer, bytes + file->map_size - sizeof(replay_footer_t), sizeof(replay_footer_t));
+        size_t body = file->map_size - prefix - closing;
+        if (memcmp(file->footer.magic, REPLAY_FOOTER_MAGIC, sizeof(file->footer.magic)) == 0 &&
+            file->footer.player_count == header->player_count &&
+            body == file->footer.record_count * sizeof(replay_record_t)) {
+            file->record_count = (size_t)file->footer.record_count;
+            file->results = (const replay_result_t*)(bytes + prefix + body);
+            return 0;
+        }
+    }
+    memset(&file->footer, 0, sizeof(file->footer)); // Sin cierre: valen los registros completos
+    file->record_count = (file->map_size - prefix) / sizeof(replay_record_t);
+    return 0;
+}
+
+void replay_file_close(replay_file_t* file) {
+    if (file->map) {
+        munmap(file->map, file->map_size);
+    }
+    file->map = NULL;
+    file->records = NULL;
+    file->results = NULL;
+}
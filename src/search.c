@@ -0,0 +1,325 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/search.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include "../include/timing.h"
+#include "../include/ttable.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define SEARCH_MAX_PLAYERS (1 + SEARCH_MAX_OPPONENTS)
+#define SEARCH_INFINITY (INT_MAX / 2)
+
+typedef struct {
+    board_t* board;
+    int count; // Jugadores en la busqueda; el 0 es el que busca
+    int id[SEARCH_MAX_PLAYERS];
+    int x[SEARCH_MAX_PLAYERS];
+    int y[SEARCH_MAX_PLAYERS];
+    int gain[SEARCH_MAX_PLAYERS]; // Puntos capturados desde la raiz
+    ttable_t* table; // NULL sin tabla de transposicion
+    uint64_t hash; // Zobrist de celdas capturadas y posiciones (sin el turno)
+    uint64_t deadline_ns;
+    unsigned long nodes;
+    bool aborted;
+    bool hit_horizon; // Alguna hoja se corto por profundidad (la iteracion no resolvio todo)
+} search_t;
+
+static int chebyshev(int ax, int ay, int bx, int by) {
+    int dx = abs(ax - bx), dy = abs(ay - by);
+    return dx > dy ? dx : dy;
+}
+
+int select_opponents(const player_t* players, unsigned int player_count, int me, int* opponents) {
+    int distances[SEARCH_MAX_OPPONENTS], found = 0;
+    for (unsigned int k = 1; k < player_count; k++) {
+        int p = (int)((me + k) % player_count);
+        if (players[p].blocked) continue;
+        int d = chebyshev(players[me].x, players[me].y, players[p].x, players[p].y);
+        if (d > SEARCH_OPPONENT_RADIUS) continue;
+        if (found < SEARCH_MAX_OPPONENTS) {
+            opponents[found] = p;
+            distances[found++] = d;
+        } else {
+            int worst = 0;
+            for (int i = 1; i < found; i++) {
+                if (distances[i] > distances[worst]) worst = i;
+            }
+            if (d >= distances[worst]) continue;
+            // Se conserva el orden de turno: se corre la cola y se agrega al final
+            for (int i = worst; i < found - 1; i++) {
+                opponents[i] = opponents[i + 1];
+                distances[i] = distances[i + 1];
+            }
+            opponents[found - 1] = p;
+            distances[found - 1] = d;
+        }
+    }
+    return found;
+}
+
+static void select_players(search_t* s, const player_t* players, unsigned int player_count, int me) {
+    s->id[0] = me;
+    s->count = 1 + select_opponents(players, player_count, me, &s->id[1]);
+    for (int i = 0; i < s->count; i++) {
+        s->x[i] = players[s->id[i]].x;
+        s->y[i] = players[s->id[i]].y;
+        s->gain[i] = 0;
+        s->hash ^= zobrist_player((unsigned int)i, (unsigned int)s->id[i], (unsigned int)(s->y[i] * s->board->width + s->x[i]));
+    }
+}
+
+// Suma de recompensas alcanzables desde (x, y) por celdas libres (relleno por inundacion):
+// cota de lo que todavia se puede juntar si se entra por ahi. Corta tras SEARCH_REGION_MAX_CELLS
+// celdas o al llegar a deadline_ns, asi que en una region abierta solo cuenta su entorno
+static int reachable_value(const board_t* board, int x, int y, uint64_t deadline_ns) {
+    static unsigned int* stamp = NULL;
+    static int* stack = NULL;
+    static size_t cells = 0;
+    static unsigned int generation = 0;
+    size_t needed = (size_t)board->width * board->height;
+    if (needed != cells) {
+        free(stamp);
+        free(stack);
+        stamp = calloc(needed, sizeof(unsigned int));
+        stack = malloc(needed * sizeof(int));
+        cells = (stamp && stack) ? needed : 0;
+        if (!cells) return 0;
+        generation = 0;
+    }
+    if (++generation == 0) { // Vuelta del contador: se limpian las marcas una vez
+        for (size_t i = 0; i < cells; i++) stamp[i] = 0;
+        generation = 1;
+    }
+
+    int top = 0, total = 0, visited = 0;
+    stamp[(size_t)y * board->width + x] = generation;
+    stack[top++] = y * board->width + x;
+    while (top > 0 && visited < SEARCH_REGION_MAX_CELLS) {
+        if (++visited % SEARCH_CLOCK_CHECK_NODES == 0 && monotonic_ns() >= deadline_ns) {
+            break;
+        }
+        int cell = stack[--top];
+        int cx = cell % board->width, cy = cell / board->width;
+        unsigned char mask = legal_move_mask(board, cx, cy);
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            if (!(mask & (1u << d))) continue;
+            int nx = cx + MOVE_DELTAS[d][0], ny = cy + MOVE_DELTAS[d][1];
+            size_t index = (size_t)ny * board->width + nx;
+            if (stamp[index] == generation) continue;
+            stamp[index] = generation;
+            total += board_cell(board, nx, ny);
+            stack[top++] = (int)index;
+        }
+    }
+    return total;
+}
+
+static bool out_of_time(search_t* s) {
+    if (++s->nodes % SEARCH_CLOCK_CHECK_NODES == 0 && monotonic_ns() >= s->deadline_ns) {
+        s->aborted = true;
+    }
+    return s->aborted;
+}
+
+// Parte de la evaluacion que depende de lo capturado desde la raiz. La tabla de transposicion
+// guarda los valores sin este termino: asi una posicion vale lo mismo (salvo redondeo) sin
+// importar desde que raiz o turno se llego a ella
+static int gain_score(const search_t* s) {
+    int score = s->gain[0] * SEARCH_GAIN_WEIGHT, opponents = 0;
+    for (int i = 1; i < s->count; i++) {
+        opponents += s->gain[i] * SEARCH_GAIN_WEIGHT;
+    }
+    return s->count > 1 ? score - opponents / (s->count - 1) : score;
+}
+
+static int evaluate(search_t* s, int plies_left) {
+    int my_moves = __builtin_popcount(legal_move_mask(s->board, s->x[0], s->y[0]));
+    int score = gain_score(s) + my_moves * SEARCH_MOBILITY_WEIGHT, opponents = 0;
+    for (int i = 1; i < s->count; i++) {
+        opponents += __builtin_popcount(legal_move_mask(s->board, s->x[i], s->y[i])) * SEARCH_MOBILITY_WEIGHT;
+    }
+    if (s->count > 1) {
+        score -= opponents / (s->count - 1);
+    }
+    if (my_moves == 0) {
+        score -= SEARCH_BLOCKED_PENALTY + plies_left * SEARCH_GAIN_WEIGHT * MAX_CELL_VALUE;
+    }
+    return score;
+}
+
+// Movimientos legales ordenados por recompensa (mayor primero); `first` va adelante si es legal
+static int ordered_moves(const search_t* s, int mover, int first, unsigned char* moves) {
+    unsigned char mask = legal_move_mask(s->board, s->x[mover], s->y[mover]);
+    int values[NUM_DIRECTIONS], n = 0;
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        if (!(mask & (1u << d))) continue;
+        int value = d == first ? SEARCH_INFINITY : board_cell(s->board, s->x[mover] + MOVE_DELTAS[d][0], s->y[mover] + MOVE_DELTAS[d][1]);
+        int i = n++;
+        while (i > 0 && values[i - 1] < value) {
+            values[i] = values[i - 1];
+            moves[i] = moves[i - 1];
+            i--;
+        }
+        values[i] = value;
+        moves[i] = (unsigned char)d;
+    }
+    return n;
+}
+
+// Cambio del hash cuando el lugar `mover` va de (fx, fy) a (tx, ty) y captura la celda destino
+static uint64_t move_hash(const search_t* s, int mover, int fx, int fy, int tx, int ty) {
+    unsigned int id = (unsigned int)s->id[mover];
+    unsigned int from = (unsigned int)(fy * s->board->width + fx), to = (unsigned int)(ty * s->board->width + tx);
+    return zobrist_cell(to, id) ^ zobrist_player((unsigned int)mover, id, from) ^ zobrist_player((unsigned int)mover, id, to);
+}
+
+static int make_move(search_t* s, int mover, int d, int* old_x, int* old_y) {
+    int nx = s->x[mover] + MOVE_DELTAS[d][0];
+    int ny = s->y[mover] + MOVE_DELTAS[d][1];
+    int value = board_cell(s->board, nx, ny);
+    set_cell_owner(s->board, nx, ny, s->id[mover]);
+    *old_x = s->x[mover];
+    *old_y = s->y[mover];
+    s->hash ^= move_hash(s, mover, *old_x, *old_y, nx, ny);
+    s->x[mover] = nx;
+    s->y[mover] = ny;
+    s->gain[mover] += value;
+    return value;
+}
+
+static void unmake_move(search_t* s, int mover, int value, int old_x, int old_y) {
+    s->hash ^= move_hash(s, mover, old_x, old_y, s->x[mover], s->y[mover]);
+    board_set_cell(s->board, s->x[mover], s->y[mover], value);
+    s->gain[mover] -= value;
+    s->x[mover] = old_x;
+    s->y[mover] = old_y;
+}
+
+static int search_node(search_t* s, int mover, int plies_left, int alpha, int beta) {
+    if (out_of_time(s)) {
+        return 0;
+    }
+    if (plies_left == 0) {
+        s->hit_horizon = true;
+        return evaluate(s, 0);
+    }
+    int next = (mover + 1) % s->count;
+    uint64_t key = s->hash ^ zobrist_turn((unsigned int)mover);
+    int base = gain_score(s);
+    int tt_move = -1;
+    const tt_entry_t* entry = s->table ? ttable_probe(s->table, key) : NULL;
+    if (entry) {
+        tt_move = entry->move == TT_NO_MOVE ? -1 : entry->move;
+        if (entry->depth >= plies_left) {
+            int score = entry->score + base;
+            if (entry->bound == TT_BOUND_EXACT
+                || (entry->bound == TT_BOUND_LOWER && score >= beta)
+                || (entry->bound == TT_BOUND_UPPER && score <= alpha)) {
+                s->hit_horizon = true; // No se sabe si ese subarbol llego al final de la partida
+                return score;
+            }
+        }
+    }
+    unsigned char moves[NUM_DIRECTIONS];
+    int n = ordered_moves(s, mover, tt_move, moves);
+    if (n == 0) {
+        if (mover == 0) {
+            return evaluate(s, plies_left); // Bloqueado: el resto de la partida ya no suma
+        }
+        return search_node(s, next, plies_left - 1, alpha, beta); // El rival pasa
+    }
+
+    bool maximizing = mover == 0;
+    int best = maximizing ? -SEARCH_INFINITY : SEARCH_INFINITY;
+    int best_move = moves[0], alpha_in = alpha, beta_in = beta;
+    for (int i = 0; i < n; i++) {
+        int old_x, old_y;
+        int value = make_move(s, mover, moves[i], &old_x, &old_y);
+        int score = search_node(s, next, plies_left - 1, alpha, beta);
+        unmake_move(s, mover, value, old_x, old_y);
+        if (s->aborted) {
+            return 0;
+        }
+        if (maximizing ? score > best : score < best) {
+            best = score;
+            best_move = moves[i];
+        }
+        if (maximizing) {
+            if (best > alpha) alpha = best;
+        } else {
+            if (best < beta) beta = best;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    if (s->table) {
+        int bound = best <= alpha_in ? TT_BOUND_UPPER : best >= beta_in ? TT_BOUND_LOWER : TT_BOUND_EXACT;
+        ttable_store(s->table, key, plies_left, bound, best - base, best_move);
+    }
+    return best;
+}
+
+signed char search_move(board_t* board, const player_t* players, unsigned int player_count, int me, uint64_t deadline_ns, ttable_t* table, uint64_t board_hash) {
+    search_t s = { .board = board, .deadline_ns = deadline_ns, .table = table, .hash = board_hash };
+    select_players(&s, players, player_count, me);
+
+    unsigned char moves[NUM_DIRECTIONS];
+    int n = ordered_moves(&s, 0, -1, moves);
+    if (n == 0) {
+        return -1;
+    }
+    if (n == 1) {
+        return (signed char)moves[0];
+    }
+
+    // La region a la que lleva cada movimiento se calcula una vez: la busqueda ve pocas rondas
+    // y sin este termino entra en bolsillos ricos pero cerrados
+    int region[NUM_DIRECTIONS] = {0};
+    int best_move = moves[0], best_region = -1;
+    for (int i = 0; i < n; i++) {
+        int old_x, old_y;
+        int value = make_move(&s, 0, moves[i], &old_x, &old_y);
+        region[moves[i]] = reachable_value(board, s.x[0], s.y[0], deadline_ns) * SEARCH_REGION_WEIGHT;
+        unmake_move(&s, 0, value, old_x, old_y);
+        if (region[moves[i]] > best_region) {
+            best_region = region[moves[i]];
+            best_move = moves[i]; // Sin ninguna iteracion completa se juega hacia la region mayor
+        }
+    }
+
+    if (monotonic_ns() >= deadline_ns) {
+        return (signed char)best_move; // Los rellenos ya usaron el tiempo: no se empieza a profundizar
+    }
+    for (int rounds = 1; rounds <= SEARCH_MAX_ROUNDS; rounds++) {
+        int plies = rounds * s.count;
+        int alpha = -SEARCH_INFINITY, iteration_move = -1;
+        s.hit_horizon = false;
+        n = ordered_moves(&s, 0, best_move, moves);
+        for (int i = 0; i < n; i++) {
+            int old_x, old_y;
+            int value = make_move(&s, 0, moves[i], &old_x, &old_y);
+            // La ventana se corre por el termino de region, que solo existe en la raiz
+            int score = search_node(&s, 1 % s.count, plies - 1, alpha - region[moves[i]], SEARCH_INFINITY);
+            unmake_move(&s, 0, value, old_x, old_y);
+            score += region[moves[i]];
+            if (s.aborted) {
+                break;
+            }
+            if (iteration_move < 0 || score > alpha) {
+                alpha = score;
+                iteration_move = moves[i];
+            }
+        }
+        if (s.aborted) {
+            break; // La iteracion incompleta se descarta
+        }
+        best_move = iteration_move;
+        if (!s.hit_horizon) {
+            break; // El arbol se resolvio entero: mas profundidad no cambia nada
+        }
+    }
+    return (signed char)best_move;
+}
@@ -0,0 +1,92 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/snapshot.h"
+#include "../include/ipc.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include <stdlib.h>
+#include <string.h>
+
+int snapshot_init(state_snapshot_t* snapshot, const game_state_t* shared) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->width = shared->width;
+    snapshot->height = shared->height;
+    snapshot->player_count = shared->player_count;
+
+    snapshot->board.width = shared->width;
+    snapshot->board.height = shared->height;
+    snapshot->board.stride = (int)shared->board_stride;
+    snapshot->board.cell_bytes = shared->cell_bytes;
+    snapshot->board.cells = malloc(board_bytes(shared->height, snapshot->board.stride, shared->cell_bytes));
+    snapshot->board.free_bits = free_plane_alloc(shared->width, shared->height);
+    snapshot->board.free_stride = free_plane_stride(shared->width);
+    snapshot->players = malloc(shared->player_count * sizeof(player_t));
+    size_t capacity = shared->delta_capacity ? shared->delta_capacity : 1;
+    snapshot->changed = malloc(capacity * sizeof(unsigned int));
+    snapshot->pending = malloc(capacity * sizeof(board_delta_t));
+    if (!snapshot->board.cells || !snapshot->board.free_bits || !snapshot->players || !snapshot->changed || !snapshot->pending) {
+        snapshot_free(snapshot);
+        return ERR_GENERIC;
+    }
+    return 0;
+}
+
+void snapshot_update(state_snapshot_t* snapshot, const game_state_t* shared) {
+    size_t bytes = board_bytes(snapshot->height, snapshot->board.stride, snapshot->board.cell_bytes);
+    board_t board = game_board(shared);
+    size_t plane_bytes = (size_t)(snapshot->height + 2) * snapshot->board.free_stride * sizeof(uint64_t);
+    const board_delta_t* ring = game_deltas(shared);
+    unsigned int capacity = shared->delta_capacity;
+    unsigned long long version;
+    unsigned long long behind;
+    bool full;
+    unsigned int seq;
+
+    do {
+        seq = state_read_begin(shared);
+        snapshot->is_game_over = shared->is_game_over;
+        version = shared->delta_version;
+        memcpy(snapshot->players, shared->players, snapshot->player_count * sizeof(player_t));
+
+        behind = version - snapshot->version;
+        full = !snapshot->synced || capacity == 0 || behind > capacity;
+        if (full) {
+            memcpy(snapshot->board.cells, board.cells, bytes);
+            if (board.free_bits) {
+                memcpy(snapshot->board.free_bits, board.free_bits, plane_bytes);
+            }
+        } else {
+            // Los deltas se copian sin aplicar: una entrada partida no debe tocar el tablero
+            for (unsigned long long k = 0; k < behind; k++) {
+                snapshot->pending[k] = ring[(snapshot->version + k) % capacity];
+            }
+        }
+    } while (state_read_retry(shared, seq));
+
+    snapshot->full_copy = full;
+    if (full && !board.free_bits) {
+        free_plane_build(&snapshot->board);
+    }
+    snapshot->changed_count = 0;
+    if (!full) {
+        for (unsigned long long k = 0; k < behind; k++) {
+            const board_delta_t* delta = &snapshot->pending[k];
+            board_set_cell(&snapshot->board, (int)(delta->cell % snapshot->width), (int)(delta->cell / snapshot->width), delta->owner);
+            snapshot->changed[snapshot->changed_count++] = delta->cell;
+        }
+    }
+    snapshot->version = version;
+    snapshot->synced = true;
+}
+
+void snapshot_free(state_snapshot_t* snapshot) {
+    free(snapshot->board.cells);
+    free_plane_release(snapshot->board.free_bits);
+    free(snapshot->players);
+    free(snapshot->changed);
+    free(snapshot->pending);
+    snapshot->board.cells = NULL;
+    snapshot->board.free_bits = NULL;
+    snapshot->players = NULL;
+    snapshot->changed = NULL;
+    snapshot->pending = NULL;
+}
@@ -0,0 +1,168 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/structs.h"
+#include "../include/ipc.h"
+#include "../include/game_stats.h"
+#include "../include/timing.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void signal_handler(int sig __attribute__((unused))) {
+    interrupted = 1;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [-g game_id] [-i ms]\n", prog);
+}
+
+// Copia contador por contador con loads atomicos: el máster sigue escribiendo mientras se lee
+static void copy_histogram(const stats_histogram_t* shared, stats_histogram_t* local) {
+    local->count = __atomic_load_n(&shared->count, __ATOMIC_ACQUIRE);
+    local->sum_ns = __atomic_load_n(&shared->sum_ns, __ATOMIC_RELAXED);
+    local->max_ns = __atomic_load_n(&shared->max_ns, __ATOMIC_RELAXED);
+    for (int b = 0; b < STATS_BUCKETS; b++) {
+        local->buckets[b] = __atomic_load_n(&shared->buckets[b], __ATOMIC_RELAXED);
+    }
+}
+
+// Lo registrado entre dos lecturas; el maximo sale del balde mas alto con muestras
+static void subtract_histogram(const stats_histogram_t* now, const stats_histogram_t* before, stats_histogram_t* delta) {
+    delta->count = now->count - before->count;
+    delta->sum_ns = now->sum_ns - before->sum_ns;
+    delta->max_ns = 0;
+    for (int b = 0; b < STATS_BUCKETS; b++) {
+        delta->buckets[b] = now->buckets[b] - before->buckets[b];
+        if (delta->buckets[b]) {
+            delta->max_ns = stats_bucket_upper_ns(b);
+        }
+    }
+    if (delta->max_ns > now->max_ns) {
+        delta->max_ns = now->max_ns;
+    }
+}
+
+static void print_table(const game_stats_t* shared, const stats_player_t* players, const char* game_id, bool interval) {
+    uint64_t moves = 0;
+    for (uint32_t i = 0; i < shared->player_count; i++) {
+        moves += players[i].stages[STATS_THINK].count;
+    }
+    uint64_t updated_ns = __atomic_load_n(&shared->updated_ns, __ATOMIC_RELAXED);
+    uint64_t now_ns = monotonic_ns();
+    printf("Partida %s (máster %ld): %llu movimientos%s, ultimo hace %.1f ms%s\n", game_id, (long)shared->master_pid,
+           (unsigned long long)moves, interval ? " en el intervalo" : "",
+           updated_ns && now_ns > updated_ns ? (double)(now_ns - updated_ns) / MS_TO_NS : 0.0,
+           __atomic_load_n(&shared->finished, __ATOMIC_ACQUIRE) ? " (terminada)" : "");
+    printf("%-4s %-8s %-10s %10s %10s %10s %10s %10s\n", "jug", "pid", "etapa", "n", "media_us", "p50_us", "p99_us", "max_us");
+    for (uint32_t i = 0; i < shared->player_count; i++) {
+        for (int s = 0; s < STATS_STAGE_COUNT; s++) {
+            const stats_histogram_t* h = &players[i].stages[s];
+            if (h->count == 0) continue;
+            printf("%-4u %-8ld %-10s %10llu %10.2f %10.2f %10.2f %10.2f\n", i, (long)shared->players[i].pid,
+                   game_stats_stage_name(s), (unsigned long long)h->count,
+                   (double)h->sum_ns / (double)h->count / US_TO_NS,
+                   (double)stats_percentile_ns(h, 50) / US_TO_NS,
+                   (double)stats_percentile_ns(h, 99) / US_TO_NS,
+                   (double)h->max_ns / US_TO_NS);
+        }
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    long interval_ms = 0; // 0: una sola lectura acumulada
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--game-id") == 0) && i + 1 < argc) {
+            const char* game_id = argv[++i];
+            if (!is_valid_game_id(game_id)) {
+                fprintf(stderr, "Error: game-id invalido (hasta %d caracteres [A-Za-z0-9_-])\n", GAME_ID_MAX_LENGTH);
+                return EXIT_FAILURE;
+            }
+            setenv(GAME_ID_ENV, game_id, 1);
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            interval_ms = atol(argv[++i]);
+            if (interval_ms < 1) interval_ms = 1;
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    const char* game_id = getenv(GAME_ID_ENV);
+    if (!game_id || game_id[0] == '\0') game_id = "(default)";
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    int fd = connect_to_shared_memory(GAME_STATS_SHM, true);
+    if (fd < 0) {
+        fprintf(stderr, "No hay estadisticas para la partida %s (¿corre el máster?)\n", game_id);
+        return EXIT_FAILURE;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(game_stats_t)) {
+        fprintf(stderr, "Segmento de estadisticas invalido\n");
+        close(fd);
+        return EXIT_FAILURE;
+    }
+    size_t size = (size_t)st.st_size;
+    const game_stats_t* shared = attach_shared_memory(fd, size, true);
+    close(fd);
+    if (!shared) {
+        return EXIT_FAILURE;
+    }
+    if (__atomic_load_n(&shared->magic, __ATOMIC_ACQUIRE) != GAME_STATS_MAGIC || shared->version != GAME_STATS_VERSION ||
+        shared->stage_count != STATS_STAGE_COUNT || shared->bucket_count != STATS_BUCKETS ||
+        size < game_stats_size((int)shared->player_count)) {
+        fprintf(stderr, "Segmento de estadisticas incompatible o sin inicializar\n");
+        detach_shared_memory((void*)shared, size);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t player_count = shared->player_count;
+    stats_player_t* before = calloc(player_count, sizeof(stats_player_t));
+    stats_player_t* now = calloc(player_count, sizeof(stats_player_t));
+    stats_player_t* delta = calloc(player_count, sizeof(stats_player_t));
+    if (!before || !now || !delta) {
+        perror("Error al reservar memoria");
+        free(before);
+        free(now);
+        free(delta);
+        detach_shared_memory((void*)shared, size);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < player_count; i++) {
+        for (int s = 0; s < STATS_STAGE_COUNT; s++) {
+            copy_histogram(&shared->players[i].stages[s], &now[i].stages[s]);
+        }
+    }
+    print_table(shared, now, game_id, false);
+
+    // Con -i: cada intervalo muestra solo lo registrado desde la lectura anterior
+    struct timespec wait = { .tv_sec = interval_ms / MS_TO_SEC, .tv_nsec = (interval_ms % MS_TO_SEC) * MS_TO_NS };
+    while (interval_ms > 0 && !interrupted && !__atomic_load_n(&shared->finished, __ATOMIC_ACQUIRE)) {
+        nanosleep(&wait, NULL);
+        if (interrupted) break;
+        stats_player_t* swap = before;
+        before = now;
+        now = swap;
+        for (uint32_t i = 0; i < player_count; i++) {
+            for (int s = 0; s < STATS_STAGE_COUNT; s++) {
+                copy_histogram(&shared->players[i].stages[s], &now[i].stages[s]);
+                subtract_histogram(&now[i].stages[s], &before[i].stages[s], &delta[i].stages[s]);
+            }
+        }
+        printf("\n");
+        print_table(shared, delta, game_id, true);
+    }
+
+    free(before);
+    free(now);
+    free(delta);
+    detach_shared_memory((void*)shared, size);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/territory.h"
+#include "../include/game_functions.h"
+#include "../include/bitboard.h"
+#include <stdlib.h>
+#include <string.h>
+
+int territory_init(territory_t* territory, int width, int height) {
+    size_t cells = (size_t)width * height;
+    memset(territory, 0, sizeof(*territory));
+    territory->width = width;
+    territory->height = height;
+    territory->opponent_stamp = calloc(cells, sizeof(unsigned int));
+    territory->opponent_dist = malloc(cells * sizeof(unsigned short));
+    territory->own_stamp = calloc(cells, sizeof(unsigned int));
+    territory->queue = malloc(cells * sizeof(int));
+    if (!territory->opponent_stamp || !territory->opponent_dist || !territory->own_stamp || !territory->queue) {
+        territory_free(territory);
+        return ERR_GENERIC;
+    }
+    return 0;
+}
+
+void territory_free(territory_t* territory) {
+    free(territory->opponent_stamp);
+    free(territory->opponent_dist);
+    free(territory->own_stamp);
+    free(territory->queue);
+    territory->opponent_stamp = NULL;
+    territory->opponent_dist = NULL;
+    territory->own_stamp = NULL;
+    territory->queue = NULL;
+}
+
+static unsigned int next_generation(territory_t* territory) {
+    if (++territory->generation == 0) { // Vuelta del contador: se limpian las marcas una vez
+        size_t cells = (size_t)territory->width * territory->height;
+        memset(territory->opponent_stamp, 0, cells * sizeof(unsigned int));
+        memset(territory->own_stamp, 0, cells * sizeof(unsigned int));
+        territory->generation = 1;
+        territory->opponent_generation = 0;
+    }
+    return territory->generation;
+}
+
+void territory_prepare(territory_t* territory, const board_t* board, const player_t* players, unsigned int player_count, int me) {
+    unsigned int generation = next_generation(territory);
+    int width = territory->width;
+    int head = 0, tail = 0;
+    // Un rival a mas de 2 * radio + 2 no llega a ninguna celda del radio antes que nosotros
+    int reach = 2 * TERRITORY_RADIUS + 2;
+    for (unsigned int p = 0; p < player_count; p++) {
+        if ((int)p == me || players[p].blocked) continue;
+        int dx = abs(players[p].x - players[me].x), dy = abs(players[p].y - players[me].y);
+        if (dx > reach || dy > reach) continue;
+        int cell = players[p].y * width + players[p].x;
+        if (territory->opponent_stamp[cell] == generation) continue;
+        territory->opponent_stamp[cell] = generation;
+        territory->opponent_dist[cell] = 0;
+        territory->queue[tail++] = cell;
+    }
+    while (head < tail) {
+        int cell = territory->queue[head++];
+        unsigned short dist = territory->opponent_dist[cell];
+        if (dist > TERRITORY_RADIUS) continue; // Mas lejos ya no compite con ninguna celda nuestra
+        int cx = cell % width, cy = cell / width;
+        unsigned char mask = legal_move_mask(board, cx, cy);
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            if (!(mask & (1u << d))) continue;
+            int next = (cy + MOVE_DELTAS[d][1]) * width + cx + MOVE_DELTAS[d][0];
+            if (territory->opponent_stamp[next] == generation) continue;
+            territory->opponent_stamp[next] = generation;
+            territory->opponent_dist[next] = (unsigned short)(dist + 1);
+            territory->queue[tail++] = next;
+        }
+    }
+    territory->opponent_generation = generation;
+}
+
+territory_result_t territory_measure(territory_t* territory, const board_t* board, int x, int y) {
+    territory_result_t result = {0, 0};
+    unsigned int generation = next_generation(territory);
+    unsigned int opponents = territory->opponent_generation;
+    int width = territory->width;
+    int head = 0, tail = 0;
+    int start = y * width + x;
+    territory->own_stamp[start] = generation;
+    territory->queue[tail++] = start;
+
+    // BFS por niveles: la distancia es la del nivel actual, sin arreglo propio de distancias
+    for (int dist = 1; dist <= TERRITORY_RADIUS && head < tail; dist++) {
+        int level_end = tail;
+        while (head < level_end) {
+            int cell = territory->queue[head++];
+            int cx = cell % width, cy = cell / width;
+            unsigned char mask = legal_move_mask(board, cx, cy);
+            for (int d = 0; d < NUM_DIRECTIONS; d++) {
+                if (!(mask & (1u << d))) continue;
+                int nx = cx + MOVE_DELTAS[d][0], ny = cy + MOVE_DELTAS[d][1];
+                int next = ny * width + nx;
+                if (territory->own_stamp[next] == generation) continue;
+                territory->own_stamp[next] = generation;
+                // Un rival que llega igual o antes se queda con la celda y corta el avance
+                if (territory->opponent_stamp[next] == opponents && territory->opponent_dist[next] <= dist) continue;
+                result.cells++;
+                result.value += board_cell(board, nx, ny);
+                territory->queue[tail++] = next;
+            }
+        }
+    }
+    return result;
+}
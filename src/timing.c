@@ -0,0 +1,24 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stddef.h>
+#include "../include/timing.h"
+#include "../include/structs.h"
+#include <stdlib.h>
+#include <time.h>
+
+uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+uint64_t percentile_ns(uint64_t* samples, size_t count, unsigned int percentile) {
+    if (count == 0) return 0;
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    return samples[(count - 1) * percentile / 100];
+}
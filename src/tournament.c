@@ -0,0 +1,459 @@
+#define _GNU_SOURCE
+#include "../include/structs.h"
+#include "../include/timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DEFAULT_MASTER_PATH "./bin/master"
+#define DEFAULT_RESULTS_PATH "tournament_results.csv"
+#define DEFAULT_TOURNAMENT_TIMEOUT 2
+#define DEFAULT_SWISS_ROUNDS 3
+#define MAX_ROSTER 64
+#define MAX_BOARD_SIZES 16
+#define SEATS_PER_GAME 2
+#define OUTPUT_CHUNK 512
+
+typedef enum {
+    FORMAT_ROUND_ROBIN,
+    FORMAT_SWISS
+} tournament_format_t;
+
+typedef struct {
+    int width;
+    int height;
+} board_size_t;
+
+typedef struct {
+    char* master_path;
+    char* results_path;
+    char* bots[MAX_ROSTER];
+    int bot_count;
+    board_size_t boards[MAX_BOARD_SIZES];
+    int board_count;
+    unsigned int first_seed;
+    int seed_count;
+    int timeout;
+    int jobs;
+    int rounds;
+    tournament_format_t format;
+} tournament_config_t;
+
+typedef struct {
+    int id;
+    int round;
+    int seats[SEATS_PER_GAME]; // indice del bot en el roster
+    board_size_t board;
+    unsigned int seed;
+} game_spec_t;
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    int cpu;
+    game_spec_t game;
+    char* output;
+    size_t length;
+    size_t capacity;
+} worker_slot_t;
+
+typedef struct {
+    unsigned int games;
+    unsigned int wins;
+    unsigned long long score;
+    unsigned long long valid_moves;
+    unsigned long long invalid_moves;
+    unsigned int points; // victorias en la ronda suiza actual y anteriores
+} standing_t;
+
+static standing_t standings[MAX_ROSTER];
+static bool played[MAX_ROSTER][MAX_ROSTER];
+static FILE* results = NULL;
+static int failed_games = 0;
+static volatile sig_atomic_t interrupted = 0;
+
+static void signal_handler(int sig __attribute__((unused))) {
+    interrupted = 1;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Uso: %s [-m master] [-j jobs] [-b WxH]... [-s seed] [-n seeds] [-t timeout]\n"
+            "          [-f roundrobin|swiss] [-r rondas] [-o resultados.csv] -p bot1 bot2 ...\n", name);
+}
+
+static bool parse_board_size(const char* text, board_size_t* board) {
+    if (sscanf(text, "%dx%d", &board->width, &board->height) != 2) return false;
+    return board->width >= MIN_BOARD_SIZE && board->height >= MIN_BOARD_SIZE;
+}
+
+static void parser(tournament_config_t* config, int argc, char* argv[]) {
+    config->master_path = DEFAULT_MASTER_PATH;
+    config->results_path = DEFAULT_RESULTS_PATH;
+    config->bot_count = 0;
+    config->board_count = 0;
+    config->first_seed = 1;
+    config->seed_count = 1;
+    config->timeout = DEFAULT_TOURNAMENT_TIMEOUT;
+    config->jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    config->rounds = DEFAULT_SWISS_ROUNDS;
+    config->format = FORMAT_ROUND_ROBIN;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            config->master_path = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            config->results_path = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            config->jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            if (config->board_count == MAX_BOARD_SIZES || !parse_board_size(argv[++i], &config->boards[config->board_count])) {
+                fprintf(stderr, "Error: tamaño de tablero invalido o demasiados tamaños (%s)\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+            config->board_count++;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config->first_seed = (unsigned int)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config->seed_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config->timeout = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            config->rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "roundrobin") == 0) {
+                config->format = FORMAT_ROUND_ROBIN;
+            } else if (strcmp(argv[i], "swiss") == 0) {
+                config->format = FORMAT_SWISS;
+            } else {
+                fprintf(stderr, "Error: formato desconocido %s\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "-p") == 0) {
+            while (i + 1 < argc && argv[i + 1][0] != '-') {
+                if (config->bot_count == MAX_ROSTER) {
+                    fprintf(stderr, "Error: Se admiten como maximo %d bots\n", MAX_ROSTER);
+                    exit(EXIT_FAILURE);
+                }
+                config->bots[config->bot_count++] = argv[++i];
+            }
+        } else {
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (config->bot_count < SEATS_PER_GAME) {
+        fprintf(stderr, "Error: Se requieren al menos %d bots (-p)\n", SEATS_PER_GAME);
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (config->board_count == 0) {
+        config->boards[0].width = MIN_BOARD_SIZE;
+        config->boards[0].height = MIN_BOARD_SIZE;
+        config->board_count = 1;
+    }
+    if (config->jobs < 1) config->jobs = 1;
+    if (config->seed_count < 1) config->seed_count = 1;
+    if (config->rounds < 1) config->rounds = 1;
+}
+
+// Agrega al lote todas las partidas de un cruce: cada tablero, cada semilla y ambos ordenes de asiento
+static int add_match(game_spec_t** games, int* count, int* capacity, const tournament_config_t* config, int round, int a, int b) {
+    for (int board = 0; board < config->board_count; board++) {
+        for (int seed = 0; seed < config->seed_count; seed++) {
+            for (int swap = 0; swap < SEATS_PER_GAME; swap++) {
+                if (*count == *capacity) {
+                    int new_capacity = *capacity ? *capacity * 2 : OUTPUT_CHUNK;
+                    game_spec_t* grown = realloc(*games, new_capacity * sizeof(game_spec_t));
+                    if (!grown) {
+                        perror("realloc");
+                        return ERR_GENERIC;
+                    }
+                    *games = grown;
+                    *capacity = new_capacity;
+                }
+                game_spec_t* game = &(*games)[(*count)++];
+                game->round = round;
+                game->seats[0] = swap ? b : a;
+                game->seats[1] = swap ? a : b;
+                game->board = config->boards[board];
+                game->seed = config->first_seed + (unsigned int)seed;
+            }
+        }
+    }
+    played[a][b] = played[b][a] = true;
+    return 0;
+}
+
+static int compare_by_points(const void* x, const void* y) {
+    int a = *(const int*)x;
+    int b = *(const int*)y;
+    if (standings[a].points != standings[b].points) {
+        return standings[a].points < standings[b].points ? 1 : -1;
+    }
+    return a - b;
+}
+
+// Empareja por puntos: cada bot juega con el siguiente de la tabla al que todavia no enfrento
+static int schedule_swiss_round(game_spec_t** games, int* count, int* capacity, const tournament_config_t* config, int round) {
+    int order[MAX_ROSTER];
+    bool paired[MAX_ROSTER] = {false};
+    for (int i = 0; i < config->bot_count; i++) order[i] = i;
+    qsort(order, config->bot_count, sizeof(int), compare_by_points);
+
+    for (int i = 0; i < config->bot_count; i++) {
+        int a = order[i];
+        if (paired[a]) continue;
+        int opponent = -1;
+        for (int j = i + 1; j < config->bot_count; j++) {
+            int b = order[j];
+            if (paired[b]) continue;
+            if (!played[a][b]) { opponent = b; break; }
+            if (opponent == -1) opponent = b; // revancha solo si no queda otra opcion
+        }
+        if (opponent == -1) continue; // cantidad impar: bye
+        paired[a] = paired[opponent] = true;
+        if (add_match(games, count, capacity, config, round, a, opponent) != 0) return ERR_GENERIC;
+    }
+    return 0;
+}
+
+static pid_t launch_game(const tournament_config_t* config, worker_slot_t* slot) {
+    int pipefd[2];
+    if (pipe(pipefd) == -1) {
+        perror("Error al crear pipe");
+        return ERR_PIPE;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("Error al crear proceso");
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return ERR_FORK;
+    }
+
+    if (pid == 0) {
+        close(pipefd[0]);
+        if (dup2(pipefd[1], STDOUT_FILENO) < 0) {
+            perror("Error haciendo el dup");
+            exit(EXIT_FAILURE);
+        }
+        close(pipefd[1]);
+
+        // Toda la partida (master y jugadores heredan la afinidad) corre en un solo core
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(slot->cpu, &cpus);
+        sched_setaffinity(0, sizeof(cpus), &cpus);
+
+        char width_str[ARG_BUFFER_SIZE], height_str[ARG_BUFFER_SIZE], seed_str[ARG_BUFFER_SIZE];
+        char timeout_str[ARG_BUFFER_SIZE], game_id[GAME_ID_MAX_LENGTH + 1];
+        snprintf(width_str, sizeof(width_str), "%d", slot->game.board.width);
+        snprintf(height_str, sizeof(height_str), "%d", slot->game.board.height);
+        snprintf(seed_str, sizeof(seed_str), "%u", slot->game.seed);
+        snprintf(timeout_str, sizeof(timeout_str), "%d", config->timeout);
+        snprintf(game_id, sizeof(game_id), "t%ld_%d", (long)getppid(), slot->game.id);
+
+        execl(config->master_path, config->master_path,
+              "-w", width_str, "-h", height_str, "-s", seed_str, "-t", timeout_str,
+              "-g", game_id, "--turbo", "--summary",
+              "-p", config->bots[slot->game.seats[0]], config->bots[slot->game.seats[1]], (char*)NULL);
+        perror("Error haciendo el execl");//no deberia llegar
+        exit(EXIT_FAILURE);
+    }
+    close(pipefd[1]);
+    slot->pid = pid;
+    slot->fd = pipefd[0];
+    slot->length = 0;
+    return pid;
+}
+
+static void append_output(worker_slot_t* slot, const char* data, size_t size) {
+    if (slot->length + size + 1 > slot->capacity) {
+        size_t capacity = slot->capacity ? slot->capacity : OUTPUT_CHUNK;
+        while (slot->length + size + 1 > capacity) capacity *= 2;
+        char* grown = realloc(slot->output, capacity);
+        if (!grown) return;
+        slot->output = grown;
+        slot->capacity = capacity;
+    }
+    memcpy(slot->output + slot->length, data, size);
+    slot->length += size;
+    slot->output[slot->length] = '\0';
+}
+
+// Interpreta las lineas de --summary del master y las vuelca al CSV y a la tabla de posiciones
+static void record_game(const tournament_config_t* config, worker_slot_t* slot, int status) {
+    unsigned int score[SEATS_PER_GAME] = {0}, valid[SEATS_PER_GAME] = {0}, invalid[SEATS_PER_GAME] = {0};
+    int winner_flag[SEATS_PER_GAME] = {0};
+    int parsed = 0;
+
+    char* saveptr = NULL;
+    for (char* line = slot->length ? strtok_r(slot->output, "\n", &saveptr) : NULL; line; line = strtok_r(NULL, "\n", &saveptr)) {
+        int seat, winner;
+        unsigned int s, v, inv;
+        if (strncmp(line, SUMMARY_PREFIX ",", strlen(SUMMARY_PREFIX) + 1) != 0) continue;
+        if (sscanf(line + strlen(SUMMARY_PREFIX) + 1, "%d,%u,%u,%u,%d", &seat, &s, &v, &inv, &winner) != 5) continue;
+        if (seat < 0 || seat >= SEATS_PER_GAME) continue;
+        score[seat] = s;
+        valid[seat] = v;
+        invalid[seat] = inv;
+        winner_flag[seat] = winner;
+        parsed++;
+    }
+
+    if (parsed != SEATS_PER_GAME || !WIFEXITED(status)) {
+        fprintf(stderr, "Partida %d sin resultado valido (semilla %u, %dx%d)\n",
+                slot->game.id, slot->game.seed, slot->game.board.width, slot->game.board.height);
+        failed_games++;
+        return;
+    }
+
+    for (int seat = 0; seat < SEATS_PER_GAME; seat++) {
+        int bot = slot->game.seats[seat];
+        fprintf(results, "%d,%d,%d,%d,%u,%d,%d,%s,%u,%u,%u,%d\n",
+                slot->game.id, slot->game.round, slot->game.board.width, slot->game.board.height, slot->game.seed,
+                seat, bot, config->bots[bot], score[seat], valid[seat], invalid[seat], winner_flag[seat]);
+        standings[bot].games++;
+        standings[bot].wins += winner_flag[seat];
+        standings[bot].points += winner_flag[seat];
+        standings[bot].score += score[seat];
+        standings[bot].valid_moves += valid[seat];
+        standings[bot].invalid_moves += invalid[seat];
+    }
+}
+
+// Corre el lote con a lo sumo config->jobs partidas en simultaneo, una por core
+static void run_games(const tournament_config_t* config, game_spec_t* games, int count, int* next_id) {
+    worker_slot_t* slots = calloc(config->jobs, sizeof(worker_slot_t));
+    struct pollfd* fds = calloc(config->jobs, sizeof(struct pollfd));
+    if (!slots || !fds) {
+        perror("calloc");
+        free(slots);
+        free(fds);
+        return;
+    }
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 0; i < config->jobs; i++) {
+        slots[i].pid = -1;
+        slots[i].fd = -1;
+        slots[i].cpu = (int)(i % (cpu_count > 0 ? cpu_count : 1));
+    }
+
+    int launched = 0, running = 0;
+    while ((launched < count && !interrupted) || running > 0) {
+        for (int i = 0; i < config->jobs && launched < count && !interrupted; i++) {
+            if (slots[i].pid != -1) continue;
+            slots[i].game = games[launched++];
+            slots[i].game.id = (*next_id)++;
+            if (launch_game(config, &slots[i]) < 0) {
+                failed_games++;
+                slots[i].pid = -1;
+                continue;
+            }
+            running++;
+        }
+
+        for (int i = 0; i < config->jobs; i++) {
+            fds[i].fd = slots[i].fd;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        if (running == 0) continue;
+        if (poll(fds, config->jobs, -1) == -1) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        for (int i = 0; i < config->jobs; i++) {
+            if (slots[i].fd == -1 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            char buffer[OUTPUT_CHUNK];
+            ssize_t n = read(slots[i].fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                append_output(&slots[i], buffer, (size_t)n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+
+            // EOF: la partida termino
+            int status = 0;
+            close(slots[i].fd);
+            waitpid(slots[i].pid, &status, 0);
+            record_game(config, &slots[i], status);
+            slots[i].fd = -1;
+            slots[i].pid = -1;
+            running--;
+        }
+    }
+
+    for (int i = 0; i < config->jobs; i++) free(slots[i].output);
+    free(slots);
+    free(fds);
+    fflush(results);
+}
+
+static void print_standings(const tournament_config_t* config, uint64_t elapsed_ns, int total_games) {
+    double elapsed_s = (double)elapsed_ns / NS_PER_SEC;
+    printf("Partidas: %d (fallidas: %d) en %.2f s (%.1f partidas/s)\n",
+           total_games, failed_games, elapsed_s, elapsed_s > 0 ? total_games / elapsed_s : 0);
+    printf("%-4s %-32s %8s %8s %12s %12s %12s\n", "bot", "binario", "partidas", "ganadas", "puntaje_prom", "validos", "invalidos");
+    for (int i = 0; i < config->bot_count; i++) {
+        standing_t* s = &standings[i];
+        printf("%-4d %-32s %8u %8u %12.1f %12llu %12llu\n", i, config->bots[i], s->games, s->wins,
+               s->games ? (double)s->score / s->games : 0.0, s->valid_moves, s->invalid_moves);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    tournament_config_t config;
+    parser(&config, argc, argv);
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    results = fopen(config.results_path, "w");
+    if (!results) {
+        perror("Error al abrir el archivo de resultados");
+        return EXIT_FAILURE;
+    }
+    fprintf(results, "game,round,width,height,seed,seat,bot,binary,score,valid_moves,invalid_moves,winner\n");
+
+    game_spec_t* games = NULL;
+    int count = 0, capacity = 0, next_id = 0;
+    uint64_t start_ns = monotonic_ns();
+
+    if (config.format == FORMAT_ROUND_ROBIN) {
+        for (int a = 0; a < config.bot_count; a++) {
+            for (int b = a + 1; b < config.bot_count; b++) {
+                if (add_match(&games, &count, &capacity, &config, 0, a, b) != 0) goto done;
+            }
+        }
+        run_games(&config, games, count, &next_id);
+    } else {
+        // Cada ronda suiza depende de la tabla de la anterior: se corre lote por lote
+        for (int round = 0; round < config.rounds && !interrupted; round++) {
+            count = 0;
+            if (schedule_swiss_round(&games, &count, &capacity, &config, round) != 0) goto done;
+            run_games(&config, games, count, &next_id);
+        }
+    }
+
+done:
+    print_standings(&config, monotonic_ns() - start_ns, next_id);
+    free(games);
+    fclose(results);
+    return (interrupted || failed_games) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 200809L
+#include "../include/ttable.h"
+#include "../include/game_functions.h"
+#include <stdlib.h>
+#include <string.h>
+
+uint64_t zobrist_board(const board_t* board) {
+    uint64_t hash = 0;
+    for (int y = 0; y < board->height; y++) {
+        for (int x = 0; x < board->width; x++) {
+            int value = board_cell(board, x, y);
+            if (value <= 0) { // Celda capturada: guarda -id del dueño
+                hash ^= zobrist_cell((unsigned int)(y * board->width + x), (unsigned int)-value);
+            }
+        }
+    }
+    return hash;
+}
+
+int ttable_init(ttable_t* table, size_t megabytes) {
+    memset(table, 0, sizeof(*table));
+    size_t limit = megabytes * 1024 * 1024 / sizeof(tt_bucket_t);
+    if (limit == 0) {
+        return 0;
+    }
+    size_t count = 1;
+    while (count * 2 <= limit) {
+        count *= 2;
+    }
+    void* buckets;
+    if (posix_memalign(&buckets, TT_CACHE_LINE_BYTES, count * sizeof(tt_bucket_t)) != 0) {
+        return ERR_GENERIC;
+    }
+    memset(buckets, 0, count * sizeof(tt_bucket_t));
+    table->buckets = buckets;
+    table->mask = count - 1;
+    return 0;
+}
+
+void ttable_free(ttable_t* table) {
+    free(table->buckets);
+    table->buckets = NULL;
+    table->mask = 0;
+}
+
+void ttable_new_turn(ttable_t* table) {
+    table->generation++;
+}
+
+const tt_entry_t* ttable_probe(const ttable_t* table, uint64_t key) {
+    if (!table->buckets) {
+        return NULL;
+    }
+    const tt_bucket_t* bucket = &table->buckets[key & table->mask];
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+        if (bucket->entries[i].key == key) {
+            return &bucket->entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Cuanto conviene conservar una entrada: profundidad menos antiguedad (en turnos)
+static int keep_priority(const ttable_t* table, const tt_entry_t* entry) {
+    int age = (uint8_t)(table->generation - entry->generation);
+    return entry->depth - age * TT_AGE_WEIGHT;
+}
+
+void ttable_store(ttable_t* table, uint64_t key, int depth, int bound, int score, int move) {
+    if (!table->buckets) {
+        return;
+    }
+    tt_bucket_t* bucket = &table->buckets[key & table->mask];
+    tt_entry_t* victim = NULL;
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+        if (bucket->entries[i].key == key) {
+            victim = &bucket->entries[i];
+            break;
+        }
+        if (bucket->entries[i].key == 0 && !victim) {
+            victim = &bucket->entries[i];
+        }
+    }
+    if (victim && victim->key == key) {
+        // Misma posicion: un resultado menos profundo del turno actual no pisa uno mejor
+        if (depth < victim->depth && victim->generation == table->generation && bound != TT_BOUND_EXACT) {
+            return;
+        }
+        if (move == TT_NO_MOVE) {
+            move = victim->move;
+        }
+    }
+    if (!victim) {
+        victim = &bucket->entries[0];
+        for (int i = 1; i < TT_BUCKET_ENTRIES; i++) {
+            if (keep_priority(table, &bucket->entries[i]) < keep_priority(table, victim)) {
+                victim = &bucket->entries[i];
+            }
+        }
+    }
+    victim->key = key;
+    victim->score = score;
+    victim->depth = (uint8_t)(depth > UINT8_MAX ? UINT8_MAX : depth);
+    victim->bound = (uint8_t)bound;
+    victim->move = (uint8_t)move;
+    victim->generation = table->generation;
+}
@@ -9,7 +9,10 @@
 #include "../include/structs.h"
 #include "../include/game_functions.h"
 #include "../include/ipc.h"
+#include "../include/snapshot.h"
+#include "../include/timing.h"
 #include <errno.h>
+#include <limits.h>
 #include <string.h>
 
 #define COLOR_PLAYER_0 COLOR_PLAYER_0_PAIR
@@ -28,12 +31,55 @@
 #define COLOR_FINISHED COLOR_FINISHED_PAIR
 #define MIN_X MIN_TERMINAL_WIDTH
 #define MIN_Y MIN_TERMINAL_HEIGHT
+#define FRAME_NOTHING INT_MIN // Celda todavia no dibujada
+#define FRAME_OCCUPANT_BASE (INT_MIN / 2) // Clave de una celda con el jugador p parado: base + p
+#define FRAME_OWNER_BASE (INT_MIN / 4) // Clave de un bloque del resumen capturado mayormente por p: base + p
+#define DETAIL_CELLS_X (2 * CELL_DISPLAY_WIDTH) // Columna de la primera celda en detalle (despues de los numeros de fila)
+#define DETAIL_CELLS_Y (BOARD_WINDOW_Y_OFFSET + 1) // Fila de la primera celda en detalle (despues de los numeros de columna)
+#define OVERVIEW_CELLS_X 2
+#define OVERVIEW_CELLS_Y BOARD_WINDOW_Y_OFFSET
+#define INFO_LINE_Y 1 // Fila de la ventana del tablero con el modo y la zona visible
+#define INFO_LINE_MAX 256
+
+typedef enum {
+    VIEW_DETAIL,         // Una celda por casillero de 3 caracteres, en una ventana que se desplaza
+    VIEW_OVERVIEW_OWNER, // Un caracter por bloque de celdas: jugador con mas celdas capturadas
+    VIEW_OVERVIEW_VALUE, // Un caracter por bloque de celdas: valor libre promedio
+    VIEW_MODE_COUNT
+} view_mode_t;
 
 static WINDOW *board_win = NULL;
 static WINDOW *status_win = NULL;
 
-static game_state_t* game_state = NULL;
-static game_sync_t* game_sync = NULL;
+static game_state_t* shared_state = NULL; // Segmento del máster (solo lectura)
+static game_state_t* game_state = NULL; // Copia completa, solo para el cartel final
+static game_sync_t* game_sync = NULL; // NULL en modo espectador
+static state_snapshot_t snapshot; // Copia que se dibuja, al dia por deltas
+
+// Dibujo diferencial: se recuerda que se dibujo en cada casillero de la pantalla y quien esta
+// parado en cada celda, asi cada cuadro solo toca las celdas cambiadas y las que dejaron o
+// pisaron los jugadores (o todo lo visible si se movio la ventana o se cambio de modo)
+static int* frame = NULL; // Clave de lo dibujado en cada casillero visible
+static size_t frame_slots = 0; // Capacidad de frame (y de los arreglos por bloque)
+static short* occupant = NULL; // Jugador parado en cada celda o -1
+static int* player_cell = NULL; // Celda de cada jugador en el cuadro anterior o -1
+
+// Ventana de detalle y resumen por bloques
+static view_mode_t view_mode = VIEW_DETAIL;
+static int follow = 0; // Jugador que sigue la ventana de detalle (-1: desplazamiento manual)
+static bool layout_valid = false; // Geometria, marco y encabezados al dia con el modo
+static bool viewport_moved = false; // Cambio origin_x/origin_y desde el ultimo cuadro
+static int slots_w, slots_h; // Casilleros visibles (celdas en detalle, bloques en el resumen)
+static int origin_x, origin_y; // Primera celda visible en detalle
+static int block_w = 1, block_h = 1; // Celdas del tablero por caracter del resumen
+
+// Reduccion por bloques del resumen: se recalcula al entrar al modo (o tras una copia completa)
+// y despues se actualiza solo con las celdas capturadas
+static unsigned char* remaining = NULL; // Valor libre de cada celda al ultimo recuento (0 si capturada)
+static int* block_value = NULL; // Suma del valor libre de cada bloque
+static int* block_free = NULL; // Celdas libres de cada bloque
+static unsigned int* block_owned = NULL; // Celdas capturadas por jugador (bloque * player_count + jugador)
+static int* block_major = NULL; // Jugador con mas celdas en el bloque o -1
 
 static volatile sig_atomic_t running = 1;
 
@@ -50,7 +96,26 @@ void cleanup_view(void) {
     if(stdscr){
         endwin();
     }
-    cleanup_shared_memory(game_state, game_sync);
+    cleanup_shared_memory(shared_state, game_sync);
+    free(game_state);
+    game_state = NULL;
+    snapshot_free(&snapshot);
+    free(frame);
+    free(occupant);
+    free(player_cell);
+    free(remaining);
+    free(block_value);
+    free(block_free);
+    free(block_owned);
+    free(block_major);
+    frame = NULL;
+    occupant = NULL;
+    player_cell = NULL;
+    remaining = NULL;
+    block_value = NULL;
+    block_free = NULL;
+    block_owned = NULL;
+    block_major = NULL;
 }
 
 void signal_handler(int sig) {
@@ -60,24 +125,13 @@ void signal_handler(int sig) {
     exit(0);
 }
 
-void read_lock(void) {
-    sem_wait(&game_sync->writer_mutex);      // Prevenir master starvation
-    sem_wait(&game_sync->reader_count_mutex); // Protejer reader counter
-    game_sync->readers_count++;              // Incrementar reader count
-    if (game_sync->readers_count == 1) {     // Primer lector?
-        sem_wait(&game_sync->state_mutex);   // Bloquear master de leer 
-    }
-    sem_post(&game_sync->reader_count_mutex); // Release counter protection
-    sem_post(&game_sync->writer_mutex);      // Permito otros lectores 
+// Aplica los movimientos publicados desde el cuadro anterior (seqlock: nunca bloquea al máster)
+void refresh_snapshot(void) {
+    snapshot_update(&snapshot, shared_state);
 }
 
-void read_unlock(void) {
-    sem_wait(&game_sync->reader_count_mutex); // Protejer reader counter
-    game_sync->readers_count--;              // Decrementar reader count
-    if (game_sync->readers_count == 0) {     // Ultimo lector?
-        sem_post(&game_sync->state_mutex);   // Permito master leer
-    }
-    sem_post(&game_sync->reader_count_mutex); // Release counter protection
+static bool shared_game_over(void) {
+    return __atomic_load_n(&shared_state->is_game_over, __ATOMIC_ACQUIRE);
 }
 
 int init_ncurses(void) {
@@ -142,6 +196,9 @@ int init_ncurses(void) {
 
     // Permitir scrollear
     scrollok(status_win, TRUE);
+    // Teclado sin bloquear: flechas y teclas de la vista se leen entre notificaciones
+    keypad(board_win, TRUE);
+    nodelay(board_win, TRUE);
     
     // Bordes
     box(board_win, 0, 0);
@@ -168,74 +225,337 @@ void draw_window_titles(void) {
     mvprintw(max_y - 8, 2, "Game Information");
 }
 
-void draw_game_board(void){
+static bool set_origin(int x, int y) {
+    if (x > snapshot.width - slots_w) x = snapshot.width - slots_w;
+    if (y > snapshot.height - slots_h) y = snapshot.height - slots_h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x == origin_x && y == origin_y) {
+        return false;
+    }
+    origin_x = x;
+    origin_y = y;
+    viewport_moved = true;
+    return true;
+}
+
+// Recentra la ventana de detalle si el jugador seguido se acerca al borde
+static void follow_player(void) {
+    if (view_mode != VIEW_DETAIL || follow < 0 || follow >= (int)snapshot.player_count) {
+        return;
+    }
+    int px = snapshot.players[follow].x, py = snapshot.players[follow].y;
+    int margin_x = VIEW_FOLLOW_MARGIN < (slots_w - 1) / 2 ? VIEW_FOLLOW_MARGIN : (slots_w - 1) / 2;
+    int margin_y = VIEW_FOLLOW_MARGIN < (slots_h - 1) / 2 ? VIEW_FOLLOW_MARGIN : (slots_h - 1) / 2;
+    int x = origin_x, y = origin_y;
+    if (px < x + margin_x || px >= x + slots_w - margin_x) x = px - slots_w / 2;
+    if (py < y + margin_y || py >= y + slots_h - margin_y) y = py - slots_h / 2;
+    set_origin(x, y);
+}
+
+static int block_index(int x, int y) {
+    return (y / block_h) * slots_w + x / block_w;
+}
+
+// Cuenta una celda recien capturada en su bloque
+static void account_capture(const board_t* board, int cell) {
+    int x = cell % snapshot.width, y = cell / snapshot.width;
+    int value = remaining[cell];
+    if (value == 0) {
+        return;
+    }
+    int b = block_index(x, y);
+    remaining[cell] = 0;
+    block_value[b] -= value;
+    block_free[b]--;
+    int owner = -get_cell_value(board, x, y) - PLAYER_ID_OFFSET;
+    if (owner < 0 || owner >= (int)snapshot.player_count) {
+        return;
+    }
+    unsigned int* owned = &block_owned[(size_t)b * snapshot.player_count];
+    owned[owner]++;
+    if (block_major[b] < 0 || owned[owner] > owned[block_major[b]]) {
+        block_major[b] = owner;
+    }
+}
+
+// Pasada de reduccion por bloques sobre todo el tablero
+static void rebuild_blocks(const board_t* board) {
+    size_t blocks = (size_t)slots_w * slots_h;
+    memset(block_value, 0, blocks * sizeof(int));
+    memset(block_free, 0, blocks * sizeof(int));
+    memset(block_owned, 0, blocks * snapshot.player_count * sizeof(unsigned int));
+    for (int y = 0; y < snapshot.height; y++) {
+        int* value_row = &block_value[(y / block_h) * slots_w];
+        int* free_row = &block_free[(y / block_h) * slots_w];
+        for (int x = 0; x < snapshot.width; x++) {
+            int cell_value = get_cell_value(board, x, y);
+            int cell = y * snapshot.width + x;
+            if (cell_value > 0) {
+                remaining[cell] = (unsigned char)cell_value;
+                value_row[x / block_w] += cell_value;
+                free_row[x / block_w]++;
+            } else {
+                int owner = -cell_value - PLAYER_ID_OFFSET;
+                remaining[cell] = 0;
+                if (owner >= 0 && owner < (int)snapshot.player_count) {
+                    block_owned[(size_t)block_index(x, y) * snapshot.player_count + owner]++;
+                }
+            }
+        }
+    }
+    for (size_t b = 0; b < blocks; b++) {
+        const unsigned int* owned = &block_owned[b * snapshot.player_count];
+        block_major[b] = -1;
+        for (unsigned int p = 0; p < snapshot.player_count; p++) {
+            if (owned[p] > 0 && (block_major[b] < 0 || owned[p] > owned[block_major[b]])) {
+                block_major[b] = (int)p;
+            }
+        }
+    }
+}
+
+// Primer jugador parado dentro del bloque (sx, sy) o -1
+static int block_head(int sx, int sy) {
+    for (unsigned int p = 0; p < snapshot.player_count; p++) {
+        if (snapshot.players[p].x / block_w == sx && snapshot.players[p].y / block_h == sy) {
+            return (int)p;
+        }
+    }
+    return -1;
+}
+
+static void draw_detail_labels(void) {
+    for (int sx = 0; sx < slots_w; sx++) {
+        // Exactamente 3 fixed chars (las dos ultimas cifras en tableros grandes)
+        mvwprintw(board_win, BOARD_WINDOW_Y_OFFSET, DETAIL_CELLS_X + sx * CELL_DISPLAY_WIDTH, "%2d ", (origin_x + sx) % 100);
+    }
+    for (int sy = 0; sy < slots_h; sy++) {
+        mvwprintw(board_win, DETAIL_CELLS_Y + sy, CELL_DISPLAY_WIDTH, "%2d ", (origin_y + sy) % 100);
+    }
+}
+
+// Dibuja el casillero solo si cambio lo que muestra (valor, dueño u ocupante)
+static void draw_slot(const board_t* board, int sx, int sy) {
+    int slot = sy * slots_w + sx;
+    if (view_mode == VIEW_DETAIL) {
+        int x = origin_x + sx, y = origin_y + sy;
+        int player_at_pos = occupant[y * snapshot.width + x];
+        int cell_value = get_cell_value(board, x, y);
+        int key = player_at_pos >= 0 ? FRAME_OCCUPANT_BASE + player_at_pos : cell_value;
+        if (frame[slot] == key) {
+            return;
+        }
+        frame[slot] = key;
+
+        const int screen_x = DETAIL_CELLS_X + sx * CELL_DISPLAY_WIDTH;
+        const int screen_y = DETAIL_CELLS_Y + sy;
+        if (player_at_pos >= 0) {
+            char buf[12];
+            snprintf(buf, sizeof(buf), "P%-2d", player_at_pos);
+            wattron(board_win, COLOR_PAIR(COLOR_PLAYER_0 + (player_at_pos % PLAYER_COLOR_COUNT)) | A_BOLD);
+            mvwaddnstr(board_win, screen_y, screen_x, buf, 3);
+            wattroff(board_win, COLOR_PAIR(COLOR_PLAYER_0 + (player_at_pos % PLAYER_COLOR_COUNT)) | A_BOLD);
+        } else if (cell_value > 0) {
+            wattron(board_win, COLOR_PAIR(COLOR_CELL_VALUE) | A_BOLD);
+            mvwprintw(board_win, screen_y, screen_x, "%-3d", cell_value);
+            wattroff(board_win, COLOR_PAIR(COLOR_CELL_VALUE) | A_BOLD);
+        } else {
+            int color = COLOR_PLAYER_0 + ((-cell_value - PLAYER_ID_OFFSET) % PLAYER_COLOR_COUNT);
+            wattron(board_win, COLOR_PAIR(color)| A_REVERSE);
+            mvwprintw(board_win, screen_y, screen_x, "   ");
+            wattroff(board_win, COLOR_PAIR(color)| A_REVERSE);
+        }
+        return;
+    }
+
+    int cells_w = snapshot.width - sx * block_w < block_w ? snapshot.width - sx * block_w : block_w;
+    int cells_h = snapshot.height - sy * block_h < block_h ? snapshot.height - sy * block_h : block_h;
+    int cells = cells_w * cells_h;
+    int head = block_head(sx, sy);
+    int key;
+    if (head >= 0) {
+        key = FRAME_OCCUPANT_BASE + head;
+    } else if (view_mode == VIEW_OVERVIEW_OWNER && block_major[slot] >= 0 && block_free[slot] * 2 < cells) {
+        key = FRAME_OWNER_BASE + block_major[slot];
+    } else {
+        key = (block_value[slot] + cells / 2) / cells; // Valor libre promedio (0-9)
+    }
+    if (frame[slot] == key) {
+        return;
+    }
+    frame[slot] = key;
+
+    const int screen_x = OVERVIEW_CELLS_X + sx;
+    const int screen_y = OVERVIEW_CELLS_Y + sy;
+    if (head >= 0) {
+        int color = COLOR_PLAYER_0 + (head % PLAYER_COLOR_COUNT);
+        wattron(board_win, COLOR_PAIR(color) | A_BOLD | A_REVERSE);
+        mvwaddch(board_win, screen_y, screen_x, (chtype)('0' + head % 10));
+        wattroff(board_win, COLOR_PAIR(color) | A_BOLD | A_REVERSE);
+    } else if (key <= FRAME_OWNER_BASE + MAX_PLAYERS) {
+        int color = COLOR_PLAYER_0 + (block_major[slot] % PLAYER_COLOR_COUNT);
+        wattron(board_win, COLOR_PAIR(color) | A_REVERSE);
+        mvwaddch(board_win, screen_y, screen_x, ' ');
+        wattroff(board_win, COLOR_PAIR(color) | A_REVERSE);
+    } else {
+        wattron(board_win, COLOR_PAIR(COLOR_CELL_VALUE) | (key >= VIEW_OVERVIEW_BRIGHT_VALUE ? A_BOLD : A_DIM));
+        mvwaddch(board_win, screen_y, screen_x, key > 0 ? (chtype)('0' + key) : '.');
+        wattroff(board_win, COLOR_PAIR(COLOR_CELL_VALUE) | (key >= VIEW_OVERVIEW_BRIGHT_VALUE ? A_BOLD : A_DIM));
+    }
+}
+
+// Redibuja el casillero que muestra la celda (si esta visible)
+static void draw_board_cell(const board_t* board, int cell) {
+    int x = cell % snapshot.width, y = cell / snapshot.width;
+    if (view_mode != VIEW_DETAIL) {
+        draw_slot(board, x / block_w, y / block_h);
+    } else if (x >= origin_x && x < origin_x + slots_w && y >= origin_y && y < origin_y + slots_h) {
+        draw_slot(board, x - origin_x, y - origin_y);
+    }
+}
+
+// Recalcula la geometria del modo actual y limpia la ventana
+static void layout_board(const board_t* board) {
+    int win_height, win_width;
+    getmaxyx(board_win, win_height, win_width);
     werase(board_win);
     box(board_win, 0, 0);
-    
+    if (view_mode == VIEW_DETAIL) {
+        slots_w = (win_width - 1 - DETAIL_CELLS_X) / CELL_DISPLAY_WIDTH;
+        slots_h = win_height - 1 - DETAIL_CELLS_Y;
+        if (slots_w > snapshot.width) slots_w = snapshot.width;
+        if (slots_h > snapshot.height) slots_h = snapshot.height;
+        set_origin(origin_x, origin_y); // Se reacomoda si la ventana nueva se pasa del tablero
+        follow_player();
+        mvwprintw(board_win, BOARD_WINDOW_Y_OFFSET, CELL_DISPLAY_WIDTH, "   ");
+        draw_detail_labels();
+    } else {
+        int area_w = win_width - 1 - OVERVIEW_CELLS_X;
+        int area_h = win_height - 1 - OVERVIEW_CELLS_Y;
+        block_w = (snapshot.width + area_w - 1) / area_w;
+        block_h = (snapshot.height + area_h - 1) / area_h;
+        slots_w = (snapshot.width + block_w - 1) / block_w;
+        slots_h = (snapshot.height + block_h - 1) / block_h;
+        rebuild_blocks(board);
+    }
+    for (int slot = 0; slot < slots_w * slots_h; slot++) {
+        frame[slot] = FRAME_NOTHING;
+    }
+    viewport_moved = false;
+    layout_valid = true;
+}
+
+static void draw_info_line(void) {
     int win_height, win_width;
     getmaxyx(board_win, win_height, win_width);
-
-    // Layout
-    int board_start_y = BOARD_WINDOW_Y_OFFSET;
-    int board_start_x = CELL_DISPLAY_WIDTH;
-    int max_board_width = win_width - (2 * CELL_DISPLAY_WIDTH);
-    int max_board_height = win_height - BOARD_MARGIN;
-    
-    // Verificar que el tablero entre
-    int required_width = game_state->width * CELL_DISPLAY_WIDTH + BOARD_MARGIN;
-    int required_height = game_state->height + BOARD_HEADER_HEIGHT;
-    
-    if (required_width > max_board_width || required_height > max_board_height) {
-        mvwprintw(board_win, win_height/2, (win_width - 20)/2, "Board too large for window");
-        return;
+    (void)win_height;
+    char info[INFO_LINE_MAX];
+    int length;
+    if (view_mode == VIEW_DETAIL) {
+        char target[32] = "libre";
+        if (follow >= 0) {
+            snprintf(target, sizeof(target), "sigue a P%d", follow);
+        }
+        length = snprintf(info, sizeof(info), " x %d-%d  y %d-%d  %s  [flechas] mover [f] seguir [o] modo",
+                          origin_x, origin_x + slots_w - 1, origin_y, origin_y + slots_h - 1, target);
+    } else {
+        length = snprintf(info, sizeof(info), " resumen %s: %dx%d celdas por caracter  [o] modo",
+                          view_mode == VIEW_OVERVIEW_OWNER ? "por dueño" : "por valor", block_w, block_h);
     }
+    int room = win_width - 2;
+    if (length > (int)sizeof(info) - 1) length = (int)sizeof(info) - 1;
+    if (length > room) length = room;
+    mvwaddnstr(board_win, INFO_LINE_Y, 1, info, length);
+    for (int x = 1 + length; x < win_width - 1; x++) {
+        mvwaddch(board_win, INFO_LINE_Y, x, ' ');
+    }
+}
 
-    // Column headers
-    mvwprintw(board_win, board_start_y, board_start_x, "   ");
-    for (int x = 0; x < game_state->width; x++) {
-        // Exactamente 3 fixed chars
-        mvwprintw(board_win, board_start_y, board_start_x + CELL_DISPLAY_WIDTH + x * CELL_DISPLAY_WIDTH, "%2d ", x);
+void draw_game_board(void){
+    board_t* board = &snapshot.board;
+    bool full = !layout_valid || snapshot.full_copy;
+    bool counted = !layout_valid; // layout_board recuenta los bloques sobre el tablero actual
+    if (!layout_valid) {
+        layout_board(board);
+    } else if (snapshot.full_copy && view_mode != VIEW_DETAIL) {
+        rebuild_blocks(board);
+        counted = true;
     }
 
-    // Rows
-    for (int y = 0; y < game_state->height; y++) {
-        // row index: 3 fixed chars
-        mvwprintw(board_win, board_start_y + 1 + y, board_start_x, "%2d ", y);
+    follow_player();
+    if (viewport_moved) {
+        draw_detail_labels();
+        viewport_moved = false;
+        full = true;
+    }
 
-        for (int x = 0; x < game_state->width; x++) {
-            const int screen_x = board_start_x + CELL_DISPLAY_WIDTH + x * CELL_DISPLAY_WIDTH;
-            const int screen_y = board_start_y + 1 + y;
+    // Jugadores que se movieron: se libera la celda que dejaron y se marca la nueva
+    for (unsigned int p = 0; p < snapshot.player_count; p++) {
+        int cell = snapshot.players[p].y * snapshot.width + snapshot.players[p].x;
+        int previous = player_cell[p];
+        if (previous == cell) continue;
+        if (previous >= 0 && occupant[previous] == (short)p) {
+            occupant[previous] = -1;
+            if (!full) draw_board_cell(board, previous);
+        }
+        occupant[cell] = (short)p;
+        player_cell[p] = cell;
+        if (!full) draw_board_cell(board, cell);
+    }
 
-            // Hay un jugador en x,y?
-            int player_at_pos = -1;
-            for (unsigned int p = 0; p < game_state->player_count; p++) {
-                if (game_state->players[p].x == x && game_state->players[p].y == y) {
-                    player_at_pos = (int)p;
-                    break;
-                }
+    if (view_mode != VIEW_DETAIL && !counted && !snapshot.full_copy) {
+        for (size_t k = 0; k < snapshot.changed_count; k++) {
+            account_capture(board, (int)snapshot.changed[k]);
+        }
+    }
+    if (full) {
+        for (int sy = 0; sy < slots_h; sy++) {
+            for (int sx = 0; sx < slots_w; sx++) {
+                draw_slot(board, sx, sy);
             }
+        }
+    } else {
+        for (size_t k = 0; k < snapshot.changed_count; k++) {
+            draw_board_cell(board, (int)snapshot.changed[k]);
+        }
+    }
+    draw_info_line();
+}
 
-            if (player_at_pos >= 0) {
-                char buf[4];
-                snprintf(buf, sizeof(buf), "P%-2d", player_at_pos);
-                wattron(board_win, COLOR_PAIR(COLOR_PLAYER_0 + (player_at_pos % MAX_PLAYERS)) | A_BOLD);
-                mvwaddnstr(board_win, screen_y, screen_x, buf, 3);
-                wattroff(board_win, COLOR_PAIR(COLOR_PLAYER_0 + (player_at_pos % MAX_PLAYERS)) | A_BOLD);
-            } else {
-                int cell_value = get_cell_value(game_state->board, x, y, game_state->width, game_state->height);
-                if (cell_value > 0) {
-                    wattron(board_win, COLOR_PAIR(COLOR_CELL_VALUE) | A_BOLD);
-                    mvwprintw(board_win, screen_y, screen_x, "%-3d", cell_value);
-                    wattroff(board_win, COLOR_PAIR(COLOR_CELL_VALUE) | A_BOLD);
-                } else {
-                    int playerid = -cell_value;
-                    wattron(board_win, COLOR_PAIR(playerid)| A_REVERSE);
-                    mvwprintw(board_win, screen_y, screen_x, "   ");
-                    wattroff(board_win, COLOR_PAIR(playerid)| A_REVERSE);
-                }
-            }
+// Teclas: flechas (o hjkl) desplazan la ventana de detalle y dejan de seguir al jugador,
+// f pasa a seguir al siguiente jugador y o cambia entre detalle y los dos resumenes.
+// Devuelve true si hay que redibujar.
+static bool handle_input(void) {
+    bool redraw = false;
+    int ch;
+    while ((ch = wgetch(board_win)) != ERR) {
+        int step_x = slots_w / VIEW_SCROLL_FRACTION > 0 ? slots_w / VIEW_SCROLL_FRACTION : 1;
+        int step_y = slots_h / VIEW_SCROLL_FRACTION > 0 ? slots_h / VIEW_SCROLL_FRACTION : 1;
+        int dx = 0, dy = 0;
+        switch (ch) {
+            case KEY_LEFT: case 'h': dx = -step_x; break;
+            case KEY_RIGHT: case 'l': dx = step_x; break;
+            case KEY_UP: case 'k': dy = -step_y; break;
+            case KEY_DOWN: case 'j': dy = step_y; break;
+            case 'f':
+                follow = (follow + 1) % (int)snapshot.player_count;
+                redraw = true;
+                break;
+            case 'o':
+                view_mode = (view_mode_t)((view_mode + 1) % VIEW_MODE_COUNT);
+                layout_valid = false;
+                redraw = true;
+                break;
+            default:
+                break;
+        }
+        if ((dx || dy) && view_mode == VIEW_DETAIL) {
+            follow = -1;
+            redraw |= set_origin(origin_x + dx, origin_y + dy);
         }
     }
+    return redraw;
 }
 
 void draw_player_status(void) {
@@ -246,28 +566,28 @@ void draw_player_status(void) {
     getmaxyx(status_win, win_height, win_width);
     (void)win_width; // Para avoider warning de unused variable
     
-    mvwprintw(status_win, 1, 2, "Players (%u):", game_state->player_count);
+    mvwprintw(status_win, 1, 2, "Players (%u):", snapshot.player_count);
     
     int line = 3;
-    for (unsigned int i = 0; i < game_state->player_count && line < win_height - 2; i++) {
+    for (unsigned int i = 0; i < snapshot.player_count && line < win_height - 2; i++) {
         
         // Player ID + Nombre
-        wattron(status_win, COLOR_PAIR(COLOR_PLAYER_0 + i) | A_BOLD);
-        mvwprintw(status_win, line, 2, "P%u: %s", i, game_state->players[i].name);
-        wattroff(status_win, COLOR_PAIR(COLOR_PLAYER_0 + i) | A_BOLD);
+        wattron(status_win, COLOR_PAIR(COLOR_PLAYER_0 + (i % PLAYER_COLOR_COUNT)) | A_BOLD);
+        mvwprintw(status_win, line, 2, "P%u: %s", i, snapshot.players[i].name);
+        wattroff(status_win, COLOR_PAIR(COLOR_PLAYER_0 + (i % PLAYER_COLOR_COUNT)) | A_BOLD);
         line++;
         
         // Player status
-        mvwprintw(status_win, line, 4, "Pos: (%d,%d)", game_state->players[i].x, game_state->players[i].y); 
+        mvwprintw(status_win, line, 4, "Pos: (%d,%d)", snapshot.players[i].x, snapshot.players[i].y); 
         line++;
-        mvwprintw(status_win, line, 4, "Score: %u", game_state->players[i].score);
+        mvwprintw(status_win, line, 4, "Score: %u", snapshot.players[i].score);
         line++;
         mvwprintw(status_win, line, 4, "Moves: %u/%u", 
-                 game_state->players[i].valid_moves, 
-                 game_state->players[i].valid_moves + game_state->players[i].invalid_moves);
+                 snapshot.players[i].valid_moves, 
+                 snapshot.players[i].valid_moves + snapshot.players[i].invalid_moves);
         line++;
         
-        if(game_state->players[i].blocked) {
+        if(snapshot.players[i].blocked) {
             wattron(status_win, COLOR_PAIR(COLOR_FINISHED) | A_BOLD);
             mvwprintw(status_win, line, 4, "[BLOCKED]");
             wattroff(status_win, COLOR_PAIR(COLOR_FINISHED) | A_BOLD);
@@ -281,10 +601,9 @@ void draw_player_status(void) {
 
 void draw_complete_view(void){
     draw_window_titles();
-    read_lock();
+    refresh_snapshot();
     draw_game_board();
     draw_player_status();
-    read_unlock();
 
     // Usa wnoutrefresh y doupdate para minimizar parpadeo
     wnoutrefresh(board_win);
@@ -297,10 +616,9 @@ static void show_winner_banner(void) {
     int winner_idx;
     unsigned winner_score;
 
-    read_lock();
+    read_state_snapshot(shared_state, game_state);
     winner_idx   = determine_winner(game_state);
     winner_score = game_state->players[winner_idx].score;
-    read_unlock();
 
     const char *title = "¡PARTIDA TERMINADA!";
     char line[128];
@@ -340,10 +658,56 @@ static void show_winner_banner(void) {
     refresh();
 }
 
+// Espectador: dibuja a fps fijos el ultimo estado consistente. No usa los semaforos de la
+// vista, asi que el máster nunca lo espera y pueden mirar varios a la vez. Lo publicado
+// entre dos cuadros se aplica junto en el siguiente (los cuadros intermedios se descartan).
+static void spectate(int fps) {
+    uint64_t period_ns = NS_PER_SEC / (uint64_t)fps;
+    uint64_t poll_ns = (uint64_t)VIEW_INPUT_POLL_MS * MS_TO_NS;
+    uint64_t next_frame_ns = monotonic_ns();
+    unsigned long long drawn_frame = 0;
+    bool drawn = false;
+    while (running) {
+        bool redraw = handle_input();
+        bool game_over = false;
+        uint64_t now_ns = monotonic_ns();
+        if (now_ns >= next_frame_ns) {
+            game_over = shared_game_over();
+            unsigned long long frame_count = __atomic_load_n(&shared_state->frame, __ATOMIC_ACQUIRE);
+            if (!drawn || frame_count != drawn_frame) {
+                redraw = true;
+                drawn = true;
+                drawn_frame = frame_count;
+            }
+            next_frame_ns += period_ns;
+            if (next_frame_ns <= now_ns) {
+                next_frame_ns = now_ns + period_ns; // Terminal lenta: se pierde el cuadro en vez de acumular atraso
+            }
+        }
+        if (redraw) {
+            draw_complete_view();
+        }
+        if (game_over) {
+            show_winner_banner();
+            return;
+        }
+
+        // Se duerme hasta el proximo cuadro, despertando antes si hay que atender el teclado
+        uint64_t wake_ns = next_frame_ns < now_ns + poll_ns ? next_frame_ns : now_ns + poll_ns;
+        struct timespec wake = { .tv_sec = (time_t)(wake_ns / NS_PER_SEC), .tv_nsec = (long)(wake_ns % NS_PER_SEC) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR && running) {
+        }
+    }
+}
 
 int main(int argc, char* argv[]){
-    if(argc != 3){
-        fprintf(stderr, "Uso: %s <width> <height>\n", argv[0]);
+    int fps = 0; // 0: sincronizada con el máster por view_notify/view_done
+    if (argc == 5 && strcmp(argv[3], "--fps") == 0) {
+        fps = atoi(argv[4]);
+        if (fps < 1) fps = 1;
+        if (fps > VIEW_MAX_FPS) fps = VIEW_MAX_FPS;
+    } else if(argc != 3){
+        fprintf(stderr, "Uso: %s <width> <height> [--fps cuadros_por_segundo]\n", argv[0]);
         return EXIT_FAILURE;
     }
 
@@ -357,47 +721,80 @@ int main(int argc, char* argv[]){
         return EXIT_FAILURE;
     }
 
-    game_state= setup_game_state(width,height);
-    game_sync = setup_game_sync();
-    if(game_state == NULL || game_sync == NULL){
+    shared_state = setup_game_state(width,height);
+    if (fps == 0) {
+        game_sync = setup_game_sync();
+    }
+    game_state = shared_state ? malloc(shared_state->total_size) : NULL;
+    if (game_state && snapshot_init(&snapshot, shared_state) == 0) {
+        // Los casilleros visibles (celdas o bloques) nunca superan los caracteres de la ventana
+        int win_height, win_width;
+        getmaxyx(board_win, win_height, win_width);
+        frame_slots = (size_t)win_height * win_width;
+        size_t cells = (size_t)width * height;
+        frame = malloc(frame_slots * sizeof(int));
+        block_value = malloc(frame_slots * sizeof(int));
+        block_free = malloc(frame_slots * sizeof(int));
+        block_major = malloc(frame_slots * sizeof(int));
+        block_owned = malloc(frame_slots * shared_state->player_count * sizeof(unsigned int));
+        occupant = malloc(cells * sizeof(short));
+        remaining = malloc(cells);
+        player_cell = malloc(shared_state->player_count * sizeof(int));
+    }
+    if(shared_state == NULL || (fps == 0 && game_sync == NULL) || game_state == NULL || !frame || !occupant || !player_cell
+       || !remaining || !block_value || !block_free || !block_major || !block_owned){
         fprintf(stderr, "Error al inicializar el estado del juego o la sincronización\n");
         cleanup_view();
         return EXIT_FAILURE;
     }
 
+    for (size_t cell = 0; cell < (size_t)width * height; cell++) {
+        occupant[cell] = -1;
+    }
+    for (unsigned int p = 0; p < shared_state->player_count; p++) {
+        player_cell[p] = -1;
+    }
+
     // Mensaje inicial
     mvprintw(LINES/2, (COLS - 40)/3, "Vista conectada - Esperando actualizaciones del juego...");
     refresh();
+
+    if (fps > 0) {
+        spectate(fps);
+        cleanup_view();
+        return 0;
+    }
     
     // Bucle principal de la vista
     while(running) {
         struct timespec timeout;
         clock_gettime(CLOCK_REALTIME, &timeout);
-        timeout.tv_sec += VIEW_WAIT_TIMEOUT_SEC; // 2 segundos timeout
+        timeout.tv_nsec += (long)VIEW_INPUT_POLL_MS * MS_TO_NS; // Espera corta para atender el teclado
+        if (timeout.tv_nsec >= NS_PER_SEC) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= NS_PER_SEC;
+        }
         
         // Esperar notificación del máster con timeout
         
         int sem_result = sem_timedwait(&game_sync->view_notify, &timeout);
         if (sem_result != 0) {
-            read_lock();
-            bool game_over = game_state->is_game_over;
-            read_unlock();
-            
-            if (game_over) {
+            if (shared_game_over()) {
                 show_winner_banner();
                 sem_post(&game_sync->view_done);
                 break;
             }
+            if (handle_input()) {
+                draw_complete_view(); // Sin movimientos nuevos: solo cambio la ventana o el modo
+            }
             continue; // Reintentar
         }
         
+        handle_input();
         draw_complete_view();
         
-        read_lock();
-        bool game_over = game_state->is_game_over;
-        read_unlock();
         // Salir si el juego terminó
-        if (game_over) {
+        if (shared_game_over()) {
             show_winner_banner();
             sem_post(&game_sync->view_done);
             break;